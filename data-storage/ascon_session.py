@@ -0,0 +1,95 @@
+import hmac
+
+import pyascon.ascon as ascon
+
+# Ascon-128a IV with the last byte set, as ascon_session_init() in
+# sensor/libs/ascon/armv6m/aead.c
+SESSION_IV = 0x80800c0800000000 ^ 0x80
+RATE = 16
+TAG_SIZE = 16
+NONCE_SIZE = 16
+
+# Frame types, sent as one byte in front of the associated data
+FRAME_RESYNC = b"R"   # new session, the session nonce precedes the type
+FRAME_CHAINED = b"S"  # continues the current session
+
+
+def _words(block: bytes):
+    return int.from_bytes(block[:8], "big"), int.from_bytes(block[8:16], "big")
+
+
+def _rate_bytes(S) -> bytes:
+    return S[0].to_bytes(8, "big") + S[1].to_bytes(8, "big")
+
+
+class AsconSession:
+    """Ascon-128a keyed duplex session, one per direction and device.
+
+    The state is initialized once per session nonce. Every frame absorbs a
+    header, encrypts the payload and squeezes a tag after one 8-round
+    permutation, and the state carries over to the next frame.
+    """
+
+    def __init__(self, key: bytes, nonce: bytes):
+        k0, k1 = _words(key)
+        n0, n1 = _words(nonce)
+        self.state = [SESSION_IV, k0, k1, n0, n1]
+        ascon.ascon_permutation(self.state, 12)
+        self.state[3] ^= k0
+        self.state[4] ^= k1
+
+    @staticmethod
+    def _absorb_header(S, header: bytes):
+        if header:
+            padded = header + b"\x80" + b"\x00" * (RATE - 1 - len(header) % RATE)
+            for i in range(0, len(padded), RATE):
+                a0, a1 = _words(padded[i:i + RATE])
+                S[0] ^= a0
+                S[1] ^= a1
+                ascon.ascon_permutation(S, 8)
+        S[4] ^= 1
+
+    def seal(self, header: bytes, plaintext: bytes) -> bytes:
+        """Encrypts one frame and returns ciphertext and tag."""
+        S = self.state
+        self._absorb_header(S, header)
+        ciphertext = b""
+        full = len(plaintext) // RATE * RATE
+        for i in range(0, full, RATE):
+            m0, m1 = _words(plaintext[i:i + RATE])
+            S[0] ^= m0
+            S[1] ^= m1
+            ciphertext += _rate_bytes(S)
+            ascon.ascon_permutation(S, 8)
+        last = plaintext[full:]
+        m0, m1 = _words(last + b"\x80" + b"\x00" * (RATE - 1 - len(last)))
+        S[0] ^= m0
+        S[1] ^= m1
+        ciphertext += _rate_bytes(S)[:len(last)]
+        ascon.ascon_permutation(S, 8)
+        return ciphertext + _rate_bytes(S)
+
+    def open(self, header: bytes, ciphertext: bytes) -> bytes:
+        """Decrypts one frame, the session only advances if the tag is valid."""
+        if len(ciphertext) < TAG_SIZE:
+            raise ValueError("Session frame too short")
+        S = list(self.state)
+        self._absorb_header(S, header)
+        body, tag = ciphertext[:-TAG_SIZE], ciphertext[-TAG_SIZE:]
+        plaintext = b""
+        full = len(body) // RATE * RATE
+        for i in range(0, full, RATE):
+            c0, c1 = _words(body[i:i + RATE])
+            plaintext += (S[0] ^ c0).to_bytes(8, "big") + (S[1] ^ c1).to_bytes(8, "big")
+            S[0], S[1] = c0, c1
+            ascon.ascon_permutation(S, 8)
+        last = body[full:]
+        rate = _rate_bytes(S)
+        plaintext += bytes(r ^ c for r, c in zip(rate, last))
+        rate = last + bytes([rate[len(last)] ^ 0x80]) + rate[len(last) + 1:]
+        S[0], S[1] = _words(rate)
+        ascon.ascon_permutation(S, 8)
+        if not hmac.compare_digest(_rate_bytes(S), tag):
+            raise ValueError("Session tag mismatch")
+        self.state = S
+        return plaintext
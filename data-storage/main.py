@@ -1,13 +1,38 @@
+import hmac
 import os
 import pyascon.ascon as ascon
+from ascon_session import AsconSession, FRAME_CHAINED, FRAME_RESYNC, NONCE_SIZE, TAG_SIZE
 import paho.mqtt.client as mqtt
 import time
 import pandas as pd
 import struct
-from cryptography.hazmat.primitives.ciphers.aead import AESGCM
+from cryptography.hazmat.primitives.ciphers.aead import AESGCM, ChaCha20Poly1305
 import sys
 import traceback
 
+# Provider ids of the sensor (ENCRYPTION_* in sensor/aead_provider.h)
+PROVIDER_TAGS = {
+    1: "masked_ASCON",
+    2: "ASCON",
+    3: "AES-GCM",
+    4: "NONE",
+    5: "ASCON_AEAD128",
+    6: "ASCON_AUTH",
+    7: "CHACHA20-POLY1305",
+}
+
+# IMPLICIT_NONCE frames carry a type byte instead of the nonce, which is the
+# salt of the sensor XOR the direction and the sequence number of the AD
+IMPLICIT_FRAME_SALT = b"K"  # the salt precedes the type
+IMPLICIT_FRAME_SEQ = b"I"
+IMPLICIT_UPLINK = 0x00
+IMPLICIT_DOWNLINK = 0x80
+
+# ASCON_AUTH tags cover the direction and the sequence number (auth_message() in sensor/encryption.c)
+AUTH_UPLINK = 0x00
+AUTH_DOWNLINK = 0x80
+
+
 class SecureMQTTClient:
 
     def __init__(self,
@@ -16,22 +41,29 @@ class SecureMQTTClient:
                  port=1883,
                  scenario=1,
                  send_back=True,
-                 crypto_algorithm_tag="ASCON"):
+                 crypto_algorithm_tag="ASCON",
+                 implicit_nonce=False):
         """Initialize the MQTT client and Ascon encryption parameters."""
         self.broker = broker
         self.port = port
         self.topic = topic
         self.scenario = int(scenario)
         # Crypto encryption parameters
-
-        self.crypto_algorithm = "ASCON" if crypto_algorithm_tag.endswith(
-            "ASCON") else crypto_algorithm_tag 
-        self.devices = {
-            "TEMP-1": bytes.fromhex("9E88CDDB2DA909937CACD4D8023F0D88")
-        } if crypto_algorithm_tag.endswith("ASCON") else {
-            "TEMP-1": AESGCM(bytes.fromhex("9E88CDDB2DA909937CACD4D8023F0D88"))
-        }
-        self.nonce_size = 16 if self.crypto_algorithm == "ASCON" else 12 if self.crypto_algorithm == "AES-GCM" else 0
+        # MULTI: sensor image with several AEAD_PROVIDERS, every frame starts
+        # with the id of its provider and each provider runs every scenario
+        self.multi = crypto_algorithm_tag == "MULTI"
+        self.seen_providers = set()
+        self._select_algorithm("AES-GCM" if self.multi else crypto_algorithm_tag)
+        # ASCON_AUTH: no nonce, values || tag || AD
+        # ASCON_SESSION: chained Ascon state per device and direction
+        self.rx_sessions = {}
+        self.tx_sessions = {}
+        # Type of the last authenticated frame of each device, its echo resyncs
+        # whenever that frame did
+        self.last_frame_types = {}
+        # IMPLICIT_NONCE: salt of the sensor per device, from its last 'K' frame
+        self.implicit_nonce = implicit_nonce
+        self.salts = {}
 
         # Initialize MQTT client
         self.client = mqtt.Client(
@@ -46,6 +78,40 @@ class SecureMQTTClient:
 
         print(f"MQTT Protocol Version: {self.client._protocol}")
 
+    def _select_algorithm(self, crypto_algorithm_tag):
+        """Sets the keys and the nonce size of crypto_algorithm_tag."""
+        self.crypto_algorithm_tag = crypto_algorithm_tag
+        self.crypto_algorithm = "ASCON" if crypto_algorithm_tag.endswith(
+            "ASCON") or crypto_algorithm_tag == "ASCON_AEAD128" else crypto_algorithm_tag 
+        # ASCON_AEAD128: NIST SP 800-232 Ascon-AEAD128 (sensor mode ASCON_AEAD128)
+        self.ascon_variant = "Ascon-AEAD128" if crypto_algorithm_tag == "ASCON_AEAD128" else "Ascon-128a"
+        self.devices = {
+            "TEMP-1": bytes.fromhex("9E88CDDB2DA909937CACD4D8023F0D88")
+        } if "ASCON" in crypto_algorithm_tag else {
+            # CHACHA20-POLY1305: key_256 of the sensor, the AES key followed by 16 more bytes
+            "TEMP-1": ChaCha20Poly1305(bytes.fromhex(
+                "9E88CDDB2DA909937CACD4D8023F0D885B1F2C7A91E43D06B86AF2470CD98315"))
+        } if crypto_algorithm_tag == "CHACHA20-POLY1305" else {
+            "TEMP-1": AESGCM(bytes.fromhex("9E88CDDB2DA909937CACD4D8023F0D88"))
+        }
+        self.nonce_size = 16 if self.crypto_algorithm == "ASCON" else 12 if self.crypto_algorithm in (
+            "AES-GCM", "CHACHA20-POLY1305") else 0
+
+    def _select_provider(self, provider_id):
+        """Switches to the provider of a MULTI frame, the first frame of a run picks the results folder."""
+        if provider_id not in PROVIDER_TAGS:
+            raise ValueError(f"Unknown provider id {provider_id}")
+        if self.results_dir is None:
+            # Every provider has run the scenario once, the sensor moved on
+            if provider_id in self.seen_providers:
+                self.seen_providers.clear()
+                self.scenario += 1
+            self.seen_providers.add(provider_id)
+            self._select_algorithm(PROVIDER_TAGS[provider_id])
+            self._create_results_dir()
+        elif PROVIDER_TAGS[provider_id] != self.crypto_algorithm_tag:
+            self._select_algorithm(PROVIDER_TAGS[provider_id])
+
     def init_scenario(self):
         # Store data
         self.receive_data_mode = False
@@ -61,16 +127,21 @@ class SecureMQTTClient:
             columns=["Start_Time", "End_Time"])
         self.stored = False  # Keeps track of if the datastorage data has been stored
 
+        self.none_seq_num = 0
+        self.results_dir = None
+        if not self.multi:
+            self._create_results_dir()
+            self.scenario += 1
+
+    def _create_results_dir(self):
         base_dir = os.path.join("results",
-                                crypto_algorithm_tag + "_scen" + str(self.scenario))
+                                self.crypto_algorithm_tag + "_scen" + str(self.scenario))
         self.results_dir = base_dir
         counter = 1
         while os.path.exists(self.results_dir):
             self.results_dir = f"{base_dir}_{counter}"
             counter += 1
         os.makedirs(self.results_dir, exist_ok=True)
-        self.scenario += 1
-        self.none_seq_num = 0
 
     def _on_connect(self, client, userdata, flags, reason_code, properties):
         """Callback when the client connects to the broker."""
@@ -88,9 +159,13 @@ class SecureMQTTClient:
                 # print(f"\nMessage received:{payload.hex()}")
                 if self._check_if_data_is_incoming(payload):
                     return
+                header = b""
+                if self.multi:
+                    header, payload = payload[:1], payload[1:]
+                    self._select_provider(header[0])
                 if self.crypto_algorithm == "NONE" and self.send_back:
                     # print("No encryption, sending back the message")
-                    self.publish(payload, "/ascon-e2e/PICO")
+                    self.publish(header + payload, "/ascon-e2e/PICO")
                     associated_data = self.parse_unencrypted_message(payload)
                     end_proccesing_time = time.perf_counter_ns()
                     seq_num = int(associated_data.decode().split("|")[-1])
@@ -100,10 +175,13 @@ class SecureMQTTClient:
                 }
                     return
                 else:
-                    ciphertext, nonce, associated_data = self._parse_encrypted_message(
+                    ciphertext, nonce, associated_data, salt = self._parse_encrypted_message(
                         payload)
                     decrypted_msg = self._decrypt_message(
                         ciphertext, nonce, associated_data)
+                    if salt is not None:
+                        # Only a 'K' frame that authenticates replaces the salt
+                        self.salts[associated_data.decode().split("|")[1]] = salt
                     # print(f"Decrypted message: {decrypted_msg}")
 
                 if self.send_back:
@@ -115,7 +193,7 @@ class SecureMQTTClient:
                     encrypted_message, nonce = self._encrypt_message(
                         encoded_bytes, associated_data=associated_data)
 
-                    message = encrypted_message + nonce + associated_data
+                    message = header + encrypted_message + nonce + associated_data
 
                     self.publish(message, "/ascon-e2e/PICO")
                     
@@ -203,17 +281,26 @@ class SecureMQTTClient:
             message: bytes,
             reciever: str = "TEMP-1",
             associated_data: bytes = b"BLE-Temp") -> tuple[bytes, bytes]:
-        """Encrypts a message using Ascon or AES-GCM-128."""
+        """Encrypts a message using Ascon, AES-GCM-128 or ChaCha20-Poly1305."""
         nonce = os.urandom(self.nonce_size)
+        if self.implicit_nonce and self.nonce_size:
+            nonce = self._implicit_nonce(reciever, associated_data, IMPLICIT_DOWNLINK)
         start_time = time.perf_counter_ns()  # ⏱️ Start time
 
-        if self.crypto_algorithm == "ASCON":
+        if self.crypto_algorithm == "ASCON_SESSION":
+            ciphertext, nonce = self._seal_session(message, reciever,
+                                                   associated_data)
+        elif self.crypto_algorithm == "ASCON_AUTH":
+            ciphertext = message + self._auth_tag(reciever, message,
+                                                  associated_data,
+                                                  AUTH_DOWNLINK)
+        elif self.crypto_algorithm == "ASCON":
             ciphertext = ascon.ascon_encrypt(self.devices[reciever],
                                              nonce,
                                              associated_data,
                                              message,
-                                             variant="Ascon-128a")
-        elif self.crypto_algorithm == "AES-GCM":
+                                             variant=self.ascon_variant)
+        elif self.crypto_algorithm in ("AES-GCM", "CHACHA20-POLY1305"):
             ciphertext = self.devices[reciever].encrypt(
                 nonce, message, associated_data)
         else:
@@ -226,6 +313,9 @@ class SecureMQTTClient:
             "End_Time": end_time,
         }
 
+        if self.implicit_nonce and self.nonce_size:
+            # The sensor derives the nonce itself
+            nonce = IMPLICIT_FRAME_SEQ
         return ciphertext, nonce
 
     def _check_if_data_is_incoming(self, payload):
@@ -272,22 +362,95 @@ class SecureMQTTClient:
         """Parses a raw byte-encoded encrypted message."""
 
         if self._check_if_data_is_incoming(payload):
-            return None, None, None
+            return None, None, None, None
 
         if len(payload) < self.nonce_size:
             print("Error: Payload too short to contain a valid nonce.")
-            return None, None, None
+            return None, None, None, None
 
         try:
             ad_start_index = payload.rindex(b"|TEMP-")
         except ValueError:
             print("Error: Associated Data not found.")
-            return None, None, None
+            return None, None, None, None
 
         associated_data = payload[ad_start_index:]  # AD starts from this index
-        nonce = payload[ad_start_index - self.nonce_size:ad_start_index]
-        ciphertext = payload[:ad_start_index - self.nonce_size]
-        return ciphertext, nonce, associated_data
+        nonce_size = self.nonce_size
+        if self.crypto_algorithm == "ASCON_SESSION":
+            # Frame type byte, preceded by the session nonce on resync frames
+            frame_type = payload[ad_start_index - 1:ad_start_index]
+            nonce_size = NONCE_SIZE + 1 if frame_type == FRAME_RESYNC else 1
+        elif self.implicit_nonce and self.nonce_size:
+            frame_type = payload[ad_start_index - 1:ad_start_index]
+            device_id = associated_data.decode().split("|")[1]
+            salt = None
+            if frame_type == IMPLICIT_FRAME_SALT:
+                nonce_size = self.nonce_size + 1
+                salt = payload[ad_start_index - nonce_size:ad_start_index - 1]
+            elif frame_type == IMPLICIT_FRAME_SEQ:
+                nonce_size = 1
+            else:
+                raise ValueError("Unknown nonce field")
+            nonce = self._implicit_nonce(device_id, associated_data, IMPLICIT_UPLINK, salt)
+            return payload[:ad_start_index - nonce_size], nonce, associated_data, salt
+        nonce = payload[ad_start_index - nonce_size:ad_start_index]
+        ciphertext = payload[:ad_start_index - nonce_size]
+        return ciphertext, nonce, associated_data, None
+
+    def _implicit_nonce(self, device_id: str, associated_data: bytes,
+                        direction: int, salt: bytes = None) -> bytes:
+        """Nonce of an IMPLICIT_NONCE frame, salt (default: the salt of device_id) XOR the direction and the sequence number."""
+        if salt is None:
+            if device_id not in self.salts:
+                raise ValueError("No salt, waiting for a salt frame")
+            salt = self.salts[device_id]
+        seq_num = int(associated_data.decode().split("|")[-1])
+        nonce = bytearray(salt)
+        nonce[0] ^= direction
+        nonce[-2] ^= (seq_num >> 8) & 0xFF
+        nonce[-1] ^= seq_num & 0xFF
+        return bytes(nonce)
+
+    def _seal_session(self, message: bytes, reciever: str,
+                      associated_data: bytes) -> tuple[bytes, bytes]:
+        """Encrypts with the session towards reciever, returns ciphertext and the nonce field."""
+        nonce_field = FRAME_CHAINED
+        if (reciever not in self.tx_sessions or
+                self.last_frame_types.get(reciever, FRAME_RESYNC) == FRAME_RESYNC):
+            # Resync together with the sensor
+            nonce = os.urandom(NONCE_SIZE)
+            self.tx_sessions[reciever] = AsconSession(self.devices[reciever], nonce)
+            nonce_field = nonce + FRAME_RESYNC
+        ciphertext = self.tx_sessions[reciever].seal(
+            nonce_field[-1:] + associated_data, message)
+        return ciphertext, nonce_field
+
+    def _open_session(self, device_id: str, ciphertext: bytes,
+                      nonce_field: bytes, associated_data: bytes) -> bytes:
+        """Decrypts with the session from device_id, starting a new one on resync frames."""
+        frame_type = nonce_field[-1:]
+        header = frame_type + associated_data
+        if frame_type == FRAME_RESYNC:
+            session = AsconSession(self.devices[device_id], nonce_field[:-1])
+            plaintext = session.open(header, ciphertext)
+            self.rx_sessions[device_id] = session
+        elif device_id not in self.rx_sessions:
+            raise ValueError("No session, waiting for resync")
+        else:
+            plaintext = self.rx_sessions[device_id].open(header, ciphertext)
+        # open() raises on a wrong tag, so only authenticated frames get here
+        self.last_frame_types[device_id] = frame_type
+        return plaintext
+
+    def _auth_tag(self, device_id: str, message: bytes,
+                  associated_data: bytes, direction: int) -> bytes:
+        """Tag of an ASCON_AUTH frame over direction, sequence number and values (see sensor/encryption.c)."""
+        seq_num = int(associated_data.decode().split("|")[-1])
+        data = bytes([direction]) + seq_num.to_bytes(2, "big") + message
+        # Single permutation Ascon-PrfShort while the input fits in 16 bytes
+        variant = "Ascon-PrfShort" if len(data) <= 16 else "Ascon-Mac"
+        return ascon.ascon_mac(self.devices[device_id], data, variant=variant,
+                               taglength=TAG_SIZE)
 
     def _decrypt_message(self, ciphertext: bytes, nonce: bytes,
                          associated_data: bytes):
@@ -299,13 +462,22 @@ class SecureMQTTClient:
         key = self.devices[device_id]
         start_time = time.perf_counter_ns()
 
-        if self.crypto_algorithm == "ASCON":
+        if self.crypto_algorithm == "ASCON_SESSION":
+            plaintext = self._open_session(device_id, ciphertext, nonce,
+                                           associated_data)
+        elif self.crypto_algorithm == "ASCON_AUTH":
+            plaintext, tag = ciphertext[:-TAG_SIZE], ciphertext[-TAG_SIZE:]
+            if len(ciphertext) < TAG_SIZE or not hmac.compare_digest(
+                    tag, self._auth_tag(device_id, plaintext, associated_data,
+                                        AUTH_UPLINK)):
+                raise ValueError("Authentication tag mismatch")
+        elif self.crypto_algorithm == "ASCON":
             plaintext = ascon.ascon_decrypt(key,
                                             nonce,
                                             associated_data,
                                             ciphertext,
-                                            variant="Ascon-128a")
-        elif self.crypto_algorithm == "AES-GCM":
+                                            variant=self.ascon_variant)
+        elif self.crypto_algorithm in ("AES-GCM", "CHACHA20-POLY1305"):
             plaintext = self.devices[device_id].decrypt(
                 nonce, ciphertext, associated_data)
         else:
@@ -338,22 +510,28 @@ class SecureMQTTClient:
 
 if __name__ == "__main__":
     if len(sys.argv) < 3 or not sys.argv[1].isdigit():
-        print("Usage: python main.py <scenario_number> <crypto_algorithm>")
+        print("Usage: python main.py <scenario_number> <crypto_algorithm> [IMPLICIT]")
         sys.exit(1)
     if len(sys.argv[1]) > 2:
         print("Scenario number should be at most 2 digits.")
         sys.exit(1)
-    if sys.argv[2] not in ["ASCON", "masked_ASCON", "AES-GCM", "NONE"]:
-        print("Usage: python main.py <scenario_number> <crypto_algorithm>")
+    if sys.argv[2] not in ["ASCON", "ASCON_AEAD128", "ASCON_AUTH", "ASCON_SESSION", "masked_ASCON", "AES-GCM", "CHACHA20-POLY1305", "NONE", "MULTI"]:
+        print("Usage: python main.py <scenario_number> <crypto_algorithm> [IMPLICIT]")
         sys.exit(1)
     scenario = sys.argv[1]
     crypto_algorithm_tag = sys.argv[2]
+    # IMPLICIT: sensor built with -DIMPLICIT_NONCE=ON
+    if len(sys.argv) > 3 and sys.argv[3] != "IMPLICIT":
+        print("Usage: python main.py <scenario_number> <crypto_algorithm> [IMPLICIT]")
+        sys.exit(1)
+    implicit_nonce = len(sys.argv) > 3
     broker = "mqtt20.iik.ntnu.no"
     topic = "/ascon-e2e/data-storage"
     client = SecureMQTTClient(broker,
                               topic,
                               scenario=scenario,
-                              crypto_algorithm_tag=crypto_algorithm_tag)
+                              crypto_algorithm_tag=crypto_algorithm_tag,
+                              implicit_nonce=implicit_nonce)
     # Connect to the broker
     client.connect()
     # Start listening for encrypted messages
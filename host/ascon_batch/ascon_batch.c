@@ -0,0 +1,330 @@
+#include "ascon_batch.h"
+
+#include <string.h>
+
+#include "api.h"
+#include "constants.h"
+#include "word.h"
+
+#if ASCON_BACKEND == ASCON_BACKEND_BI32
+#error "ascon_batch uses the standard (non-interleaved) word layout"
+#endif
+
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+#define LANES 8
+typedef __m512i vec_t;
+#define VXOR(a, b) _mm512_xor_si512(a, b)
+#define VAND(a, b) _mm512_and_si512(a, b)
+#define VANDN(a, b) _mm512_andnot_si512(a, b)
+#define VOR(a, b) _mm512_or_si512(a, b)
+#define VROR(a, n) _mm512_ror_epi64(a, n)
+#define VSET1(x) _mm512_set1_epi64((long long)(x))
+#define VLOAD(p) _mm512_load_si512((const void*)(p))
+#define VSTORE(p, v) _mm512_store_si512((void*)(p), v)
+
+#elif defined(__AVX2__)
+
+#include <immintrin.h>
+#define LANES 4
+typedef __m256i vec_t;
+#define VXOR(a, b) _mm256_xor_si256(a, b)
+#define VAND(a, b) _mm256_and_si256(a, b)
+#define VANDN(a, b) _mm256_andnot_si256(a, b)
+#define VOR(a, b) _mm256_or_si256(a, b)
+#define VROR(a, n) \
+  _mm256_or_si256(_mm256_srli_epi64(a, n), _mm256_slli_epi64(a, 64 - (n)))
+#define VSET1(x) _mm256_set1_epi64x((long long)(x))
+#define VLOAD(p) _mm256_load_si256((const __m256i*)(p))
+#define VSTORE(p, v) _mm256_store_si256((__m256i*)(p), v)
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+#define LANES 2
+typedef __m128i vec_t;
+#define VXOR(a, b) _mm_xor_si128(a, b)
+#define VAND(a, b) _mm_and_si128(a, b)
+#define VANDN(a, b) _mm_andnot_si128(a, b)
+#define VOR(a, b) _mm_or_si128(a, b)
+#define VROR(a, n) _mm_or_si128(_mm_srli_epi64(a, n), _mm_slli_epi64(a, 64 - (n)))
+#define VSET1(x) _mm_set1_epi64x((long long)(x))
+#define VLOAD(p) _mm_load_si128((const __m128i*)(p))
+#define VSTORE(p, v) _mm_store_si128((__m128i*)(p), v)
+
+#else
+
+#define LANES 1
+typedef uint64_t vec_t;
+#define VXOR(a, b) ((a) ^ (b))
+#define VAND(a, b) ((a) & (b))
+#define VANDN(a, b) (~(a) & (b))
+#define VOR(a, b) ((a) | (b))
+#define VROR(a, n) ROR(a, n)
+#define VSET1(x) ((uint64_t)(x))
+#define VLOAD(p) (*(p))
+#define VSTORE(p, v) (*(p) = (v))
+
+#endif
+
+/* select a where the mask is set and b elsewhere */
+#define VSEL(mask, a, b) VOR(VAND(mask, a), VANDN(mask, b))
+
+/* state of all lanes, word i of lane l is x[i][l] */
+typedef struct {
+  _Alignas(64) uint64_t x[5][LANES];
+} batch_state_t;
+
+typedef enum { LANE_IDLE, LANE_INIT, LANE_ADATA, LANE_CIPHER, LANE_FINAL } lane_phase_t;
+
+typedef struct {
+  ascon_frame_t* frame;
+  uint64_t k0, k1;
+  const uint8_t* ad;
+  uint64_t adlen;
+  int ad_done;
+  const uint8_t* c;
+  uint8_t* m;
+  uint64_t clen;
+  lane_phase_t phase;
+} batch_lane_t;
+
+forceinline void vround(vec_t* x0, vec_t* x1, vec_t* x2, vec_t* x3, vec_t* x4,
+                        uint64_t C) {
+  vec_t t0, t1, t2, t3, t4;
+  /* round constant */
+  *x2 = VXOR(*x2, VSET1(C));
+  /* s-box layer */
+  *x0 = VXOR(*x0, *x4);
+  *x4 = VXOR(*x4, *x3);
+  *x2 = VXOR(*x2, *x1);
+  t0 = VXOR(*x0, VANDN(*x1, *x2));
+  t1 = VXOR(*x1, VANDN(*x2, *x3));
+  t2 = VXOR(*x2, VANDN(*x3, *x4));
+  t3 = VXOR(*x3, VANDN(*x4, *x0));
+  t4 = VXOR(*x4, VANDN(*x0, *x1));
+  t1 = VXOR(t1, t0);
+  t0 = VXOR(t0, t4);
+  t3 = VXOR(t3, t2);
+  t2 = VXOR(t2, VSET1(~0ull));
+  /* linear layer */
+  *x0 = VXOR(t0, VXOR(VROR(t0, 19), VROR(t0, 28)));
+  *x1 = VXOR(t1, VXOR(VROR(t1, 61), VROR(t1, 39)));
+  *x2 = VXOR(t2, VXOR(VROR(t2, 1), VROR(t2, 6)));
+  *x3 = VXOR(t3, VXOR(VROR(t3, 10), VROR(t3, 17)));
+  *x4 = VXOR(t4, VXOR(VROR(t4, 7), VROR(t4, 41)));
+}
+
+/* run P12 on lanes that need 12 rounds and P8 on all others */
+static void batch_permute(batch_state_t* s, const int nr[LANES]) {
+  _Alignas(64) uint64_t p12[LANES];
+  int any12 = 0;
+  for (int l = 0; l < LANES; ++l) {
+    p12[l] = (nr[l] == 12) ? ~0ull : 0;
+    any12 |= (nr[l] == 12);
+  }
+  vec_t x0 = VLOAD(s->x[0]), x1 = VLOAD(s->x[1]), x2 = VLOAD(s->x[2]);
+  vec_t x3 = VLOAD(s->x[3]), x4 = VLOAD(s->x[4]);
+  if (any12) {
+    /* P12 is four extra leading rounds in front of P8 */
+    vec_t y0 = x0, y1 = x1, y2 = x2, y3 = x3, y4 = x4;
+    vec_t mask = VLOAD(p12);
+    vround(&y0, &y1, &y2, &y3, &y4, RC0);
+    vround(&y0, &y1, &y2, &y3, &y4, RC1);
+    vround(&y0, &y1, &y2, &y3, &y4, RC2);
+    vround(&y0, &y1, &y2, &y3, &y4, RC3);
+    x0 = VSEL(mask, y0, x0);
+    x1 = VSEL(mask, y1, x1);
+    x2 = VSEL(mask, y2, x2);
+    x3 = VSEL(mask, y3, x3);
+    x4 = VSEL(mask, y4, x4);
+  }
+  vround(&x0, &x1, &x2, &x3, &x4, RC4);
+  vround(&x0, &x1, &x2, &x3, &x4, RC5);
+  vround(&x0, &x1, &x2, &x3, &x4, RC6);
+  vround(&x0, &x1, &x2, &x3, &x4, RC7);
+  vround(&x0, &x1, &x2, &x3, &x4, RC8);
+  vround(&x0, &x1, &x2, &x3, &x4, RC9);
+  vround(&x0, &x1, &x2, &x3, &x4, RCa);
+  vround(&x0, &x1, &x2, &x3, &x4, RCb);
+  VSTORE(s->x[0], x0);
+  VSTORE(s->x[1], x1);
+  VSTORE(s->x[2], x2);
+  VSTORE(s->x[3], x3);
+  VSTORE(s->x[4], x4);
+}
+
+#define X(i) s->x[i][l]
+
+/* load the next frame into lane l, returns 0 if there is none left */
+static int lane_start(batch_state_t* s, batch_lane_t* lane, int l,
+                      ascon_frame_t* frame) {
+  if (!frame) {
+    lane->phase = LANE_IDLE;
+    return 0;
+  }
+  lane->frame = frame;
+  if (frame->clen < CRYPTO_ABYTES) {
+    frame->result = -1;
+    lane->phase = LANE_IDLE;
+    return -1;
+  }
+  frame->mlen = frame->clen - CRYPTO_ABYTES;
+  lane->k0 = LOAD(frame->k, 8);
+  lane->k1 = LOAD(frame->k + 8, 8);
+  lane->ad = frame->ad;
+  lane->adlen = frame->adlen;
+  lane->ad_done = (frame->adlen == 0);
+  lane->c = frame->c;
+  lane->m = frame->m;
+  lane->clen = frame->mlen;
+  X(0) = ASCON_AEAD_IV;
+  X(1) = lane->k0;
+  X(2) = lane->k1;
+  X(3) = LOAD(frame->npub, 8);
+  X(4) = LOAD(frame->npub + 8, 8);
+  lane->phase = LANE_INIT;
+  return 12;
+}
+
+/* scalar work of lane l up to its next permutation, returns its rounds */
+static int lane_next(batch_state_t* s, batch_lane_t* lane, int l) {
+  uint64_t cx;
+  switch (lane->phase) {
+    case LANE_INIT:
+      X(3) ^= lane->k0;
+      X(4) ^= lane->k1;
+      lane->phase = LANE_ADATA;
+      /* fall through */
+    case LANE_ADATA:
+      if (!lane->ad_done) {
+        if (lane->adlen >= ASCON_AEAD_RATE) {
+          /* full associated data block */
+          X(0) ^= LOAD(lane->ad, 8);
+          X(1) ^= LOAD(lane->ad + 8, 8);
+          lane->ad += ASCON_AEAD_RATE;
+          lane->adlen -= ASCON_AEAD_RATE;
+          return 8;
+        }
+        /* final associated data block */
+        uint64_t* px = &X(0);
+        if (lane->adlen >= 8) {
+          X(0) ^= LOAD(lane->ad, 8);
+          px = &X(1);
+          lane->ad += 8;
+          lane->adlen -= 8;
+        }
+        *px ^= PAD(lane->adlen);
+        if (lane->adlen) *px ^= LOADBYTES(lane->ad, lane->adlen);
+        lane->ad_done = 1;
+        return 8;
+      }
+      /* domain separation */
+      X(4) ^= DSEP();
+      lane->phase = LANE_CIPHER;
+      /* fall through */
+    case LANE_CIPHER:
+      if (lane->clen >= ASCON_AEAD_RATE) {
+        /* full ciphertext block */
+        cx = LOAD(lane->c, 8);
+        X(0) ^= cx;
+        STORE(lane->m, X(0), 8);
+        X(0) = cx;
+        cx = LOAD(lane->c + 8, 8);
+        X(1) ^= cx;
+        STORE(lane->m + 8, X(1), 8);
+        X(1) = cx;
+        lane->m += ASCON_AEAD_RATE;
+        lane->c += ASCON_AEAD_RATE;
+        lane->clen -= ASCON_AEAD_RATE;
+        return 8;
+      } else {
+        /* final ciphertext block */
+        uint64_t* px = &X(0);
+        uint64_t clen = lane->clen;
+        if (clen >= 8) {
+          cx = LOAD(lane->c, 8);
+          X(0) ^= cx;
+          STORE(lane->m, X(0), 8);
+          X(0) = cx;
+          px = &X(1);
+          lane->m += 8;
+          lane->c += 8;
+          clen -= 8;
+        }
+        *px ^= PAD(clen);
+        if (clen) {
+          cx = LOADBYTES(lane->c, clen);
+          *px ^= cx;
+          STOREBYTES(lane->m, *px, clen);
+          *px = CLEAR(*px, clen);
+          *px ^= cx;
+        }
+        /* finalization */
+        X(2) ^= lane->k0;
+        X(3) ^= lane->k1;
+        lane->phase = LANE_FINAL;
+        return 12;
+      }
+    case LANE_FINAL:
+    case LANE_IDLE:
+    default:
+      return 0;
+  }
+}
+
+/* check the tag of the finished frame in lane l */
+static void lane_finish(batch_state_t* s, batch_lane_t* lane, int l) {
+  const uint8_t* t = lane->frame->c + lane->frame->mlen;
+  X(3) ^= lane->k0;
+  X(4) ^= lane->k1;
+  X(3) ^= LOADBYTES(t, 8);
+  X(4) ^= LOADBYTES(t + 8, 8);
+  lane->frame->result = NOTZERO(X(3), X(4));
+}
+
+int ascon_batch_lanes(void) { return LANES; }
+
+size_t ascon_aead_decrypt_batch(size_t n, ascon_frame_t frames[]) {
+  batch_state_t state;
+  batch_state_t* s = &state;
+  batch_lane_t lanes[LANES];
+  int nr[LANES];
+  size_t next = 0, failed = 0;
+  int active = 0;
+
+  memset(s, 0, sizeof(*s));
+  for (int l = 0; l < LANES; ++l) {
+    do {
+      nr[l] = lane_start(s, &lanes[l], l, next < n ? &frames[next] : NULL);
+      if (next < n) ++next;
+    } while (nr[l] < 0);
+    active += (nr[l] != 0);
+  }
+
+  while (active) {
+    batch_permute(s, nr);
+    active = 0;
+    for (int l = 0; l < LANES; ++l) {
+      if (lanes[l].phase == LANE_IDLE) {
+        nr[l] = 0;
+        continue;
+      }
+      if (lanes[l].phase == LANE_FINAL) {
+        /* retire the lane and refill it with the next frame */
+        lane_finish(s, &lanes[l], l);
+        do {
+          nr[l] = lane_start(s, &lanes[l], l, next < n ? &frames[next] : NULL);
+          if (next < n) ++next;
+        } while (nr[l] < 0);
+      } else {
+        nr[l] = lane_next(s, &lanes[l], l);
+      }
+      active += (nr[l] != 0);
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) failed += (frames[i].result != 0);
+  return failed;
+}
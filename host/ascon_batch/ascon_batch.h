@@ -0,0 +1,34 @@
+#ifndef ASCON_BATCH_H_
+#define ASCON_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* one independent Ascon-128a frame, same layout as crypto_aead_decrypt */
+typedef struct {
+  unsigned char* m;            /* plaintext output, clen - CRYPTO_ABYTES */
+  unsigned long long mlen;     /* set to clen - CRYPTO_ABYTES */
+  const unsigned char* c;      /* ciphertext followed by the tag */
+  unsigned long long clen;
+  const unsigned char* ad;
+  unsigned long long adlen;
+  const unsigned char* npub;
+  const unsigned char* k;
+  int result;                  /* 0 if authentic, -1 otherwise */
+} ascon_frame_t;
+
+/* number of frames processed in parallel (2 SSE2, 4 AVX2, 8 AVX-512) */
+int ascon_batch_lanes(void);
+
+/* decrypt and verify n frames, returns the number of frames that failed */
+size_t ascon_aead_decrypt_batch(size_t n, ascon_frame_t frames[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ASCON_BATCH_H_ */
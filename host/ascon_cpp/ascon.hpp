@@ -0,0 +1,294 @@
+#ifndef ASCON_HPP_
+#define ASCON_HPP_
+
+/* header-only C++17 Ascon aead for host tools, same algorithm as aead.c in
+ * sensor/libs/ascon/armv6m with the rate and rounds as template parameters,
+ * so every permutation is unrolled with constant round constants */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "constants.h"
+
+static_assert(ASCON_BACKEND != ASCON_BACKEND_BI32,
+              "ascon.hpp uses the constants of the 64-bit word layout");
+
+namespace ascon {
+
+/* non-owning view of contiguous bytes, like std::span<T> in C++20 */
+template <typename T>
+class Span {
+ public:
+  constexpr Span() noexcept = default;
+  constexpr Span(T* data, std::size_t size) noexcept
+      : data_(data), size_(size) {}
+  /* containers of bytes only, size() counts elements */
+  template <typename Container,
+            typename = decltype(std::declval<Container&>().data()),
+            typename = std::enable_if_t<
+                sizeof(typename Container::value_type) == 1>>
+  constexpr Span(Container& c) noexcept
+      : data_(reinterpret_cast<T*>(c.data())), size_(c.size()) {}
+  template <std::size_t N>
+  constexpr Span(T (&a)[N]) noexcept : data_(a), size_(N) {}
+
+  constexpr T* data() const noexcept { return data_; }
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr Span subspan(std::size_t off, std::size_t n) const noexcept {
+    return Span(data_ + off, n);
+  }
+
+ private:
+  T* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+using Bytes = Span<std::uint8_t>;
+using ConstBytes = Span<const std::uint8_t>;
+
+using State = std::array<std::uint64_t, 5>;
+
+namespace detail {
+
+/* round constants of constants.h, indexed by round */
+constexpr std::array<std::uint8_t, 12> kRoundConstants = {
+    RC0, RC1, RC2, RC3, RC4, RC5, RC6, RC7, RC8, RC9, RCa, RCb};
+
+constexpr std::uint64_t ror(std::uint64_t x, int n) {
+  return x >> n | x << (-n & 63);
+}
+
+inline std::uint64_t load(const std::uint8_t* b, std::size_t n) {
+  std::uint64_t x = 0;
+  for (std::size_t i = 0; i < n; ++i) x |= std::uint64_t{b[i]} << (56 - 8 * i);
+  return x;
+}
+
+inline void store(std::uint8_t* b, std::uint64_t x, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i)
+    b[i] = static_cast<std::uint8_t>(x >> (56 - 8 * i));
+}
+
+constexpr std::uint64_t pad(std::size_t i) { return 0x80ull << (56 - 8 * i); }
+
+constexpr std::uint64_t clear(std::uint64_t w, std::size_t n) {
+  return n ? w & (~0ull >> (8 * n)) : w;
+}
+
+inline void round(State& s, std::uint8_t c) {
+  State t;
+  s[2] ^= c;
+  /* s-box layer */
+  s[0] ^= s[4];
+  s[4] ^= s[3];
+  s[2] ^= s[1];
+  t[0] = s[0] ^ (~s[1] & s[2]);
+  t[2] = s[2] ^ (~s[3] & s[4]);
+  t[4] = s[4] ^ (~s[0] & s[1]);
+  t[1] = s[1] ^ (~s[2] & s[3]);
+  t[3] = s[3] ^ (~s[4] & s[0]);
+  t[1] ^= t[0];
+  t[3] ^= t[2];
+  t[0] ^= t[4];
+  /* linear layer */
+  s[2] = t[2] ^ ror(t[2], 6 - 1);
+  s[3] = t[3] ^ ror(t[3], 17 - 10);
+  s[4] = t[4] ^ ror(t[4], 41 - 7);
+  s[0] = t[0] ^ ror(t[0], 28 - 19);
+  s[1] = t[1] ^ ror(t[1], 61 - 39);
+  s[2] = t[2] ^ ror(s[2], 1);
+  s[3] = t[3] ^ ror(s[3], 10);
+  s[4] = t[4] ^ ror(s[4], 7);
+  s[0] = t[0] ^ ror(s[0], 19);
+  s[1] = t[1] ^ ror(s[1], 39);
+  s[2] = ~s[2];
+}
+
+template <std::size_t Rounds, std::size_t... I>
+inline void permute(State& s, std::index_sequence<I...>) {
+  (round(s, kRoundConstants[12 - Rounds + I]), ...);
+}
+
+}  // namespace detail
+
+/* Ascon permutation with Rounds rounds (P6, P8, P12), fully unrolled */
+template <std::size_t Rounds>
+inline void permute(State& s) {
+  static_assert(Rounds >= 1 && Rounds <= 12, "Ascon has at most 12 rounds");
+  detail::permute<Rounds>(s, std::make_index_sequence<Rounds>{});
+}
+
+/* Ascon aead with a 16 byte key, nonce and tag, Rate (8 or 16) bytes and
+ * Rounds rounds per block. Aead<16, 8> is Ascon-128a and matches
+ * crypto_aead_encrypt, Aead<8, 6> is Ascon-128. */
+template <std::size_t Rate, std::size_t Rounds>
+class Aead {
+  static_assert(Rate == 8 || Rate == 16, "Ascon rate is 8 or 16 bytes");
+
+ public:
+  static constexpr std::size_t kKeyBytes = 16;
+  static constexpr std::size_t kNonceBytes = 16;
+  static constexpr std::size_t kTagBytes = 16;
+  static constexpr std::size_t kRate = Rate;
+  /* key bits, rate bits, initialization and block rounds */
+  static constexpr std::uint64_t kIv =
+      std::uint64_t{kKeyBytes * 8} << 56 | std::uint64_t{Rate * 8} << 48 |
+      std::uint64_t{12} << 40 | std::uint64_t{Rounds} << 32;
+
+  /* loads the key once, the object can seal and open any number of frames */
+  explicit Aead(const std::uint8_t* key)
+      : k0_(detail::load(key, 8)), k1_(detail::load(key + 8, 8)) {}
+
+  /* encrypts data in place and writes the tag */
+  void encrypt(Bytes data, ConstBytes ad, const std::uint8_t* nonce,
+               std::uint8_t* tag) const {
+    State s = init(nonce);
+    absorb(s, ad);
+    std::uint8_t* p = data.data();
+    std::size_t len = data.size();
+    /* full blocks */
+    for (; len >= Rate; p += Rate, len -= Rate) {
+      s[0] ^= detail::load(p, 8);
+      detail::store(p, s[0], 8);
+      if (Rate == 16) {
+        s[1] ^= detail::load(p + 8, 8);
+        detail::store(p + 8, s[1], 8);
+      }
+      permute<Rounds>(s);
+    }
+    /* final block */
+    std::uint64_t* px = &s[0];
+    if (Rate == 16 && len >= 8) {
+      s[0] ^= detail::load(p, 8);
+      detail::store(p, s[0], 8);
+      px = &s[1];
+      p += 8;
+      len -= 8;
+    }
+    *px ^= detail::pad(len) ^ detail::load(p, len);
+    detail::store(p, *px, len);
+    finalize(s, tag);
+  }
+
+  /* decrypts data in place, returns false and wipes data if the tag is
+   * wrong */
+  bool decrypt(Bytes data, ConstBytes ad, const std::uint8_t* nonce,
+               const std::uint8_t* tag) const {
+    State s = init(nonce);
+    absorb(s, ad);
+    std::uint8_t* p = data.data();
+    std::size_t len = data.size();
+    /* full blocks */
+    for (; len >= Rate; p += Rate, len -= Rate) {
+      std::uint64_t cx = detail::load(p, 8);
+      detail::store(p, s[0] ^ cx, 8);
+      s[0] = cx;
+      if (Rate == 16) {
+        cx = detail::load(p + 8, 8);
+        detail::store(p + 8, s[1] ^ cx, 8);
+        s[1] = cx;
+      }
+      permute<Rounds>(s);
+    }
+    /* final block */
+    std::uint64_t* px = &s[0];
+    if (Rate == 16 && len >= 8) {
+      std::uint64_t cx = detail::load(p, 8);
+      detail::store(p, s[0] ^ cx, 8);
+      s[0] = cx;
+      px = &s[1];
+      p += 8;
+      len -= 8;
+    }
+    std::uint64_t cx = detail::load(p, len);
+    detail::store(p, *px ^ cx, len);
+    *px = detail::clear(*px, len) ^ cx ^ detail::pad(len);
+    std::uint8_t t[kTagBytes];
+    finalize(s, t);
+    /* constant time compare */
+    std::uint8_t diff = 0;
+    for (std::size_t i = 0; i < kTagBytes; ++i) diff |= t[i] ^ tag[i];
+    if (diff == 0) return true;
+    std::fill(data.data(), data.data() + data.size(), 0);
+    return false;
+  }
+
+  /* c = ciphertext || tag, c holds m.size() + kTagBytes bytes and may start
+   * at m.data() */
+  void seal(std::uint8_t* c, ConstBytes m, ConstBytes ad,
+            const std::uint8_t* nonce) const {
+    if (c != m.data()) std::copy(m.data(), m.data() + m.size(), c);
+    encrypt(Bytes(c, m.size()), ad, nonce, c + m.size());
+  }
+
+  /* m = plaintext of c = ciphertext || tag, m may start at c.data() */
+  bool open(std::uint8_t* m, ConstBytes c, ConstBytes ad,
+            const std::uint8_t* nonce) const {
+    if (c.size() < kTagBytes) return false;
+    std::size_t mlen = c.size() - kTagBytes;
+    std::uint8_t t[kTagBytes];
+    std::copy(c.data() + mlen, c.data() + c.size(), t);
+    if (m != c.data()) std::copy(c.data(), c.data() + mlen, m);
+    return decrypt(Bytes(m, mlen), ad, nonce, t);
+  }
+
+ private:
+  State init(const std::uint8_t* nonce) const {
+    State s = {kIv, k0_, k1_, detail::load(nonce, 8),
+               detail::load(nonce + 8, 8)};
+    permute<12>(s);
+    s[3] ^= k0_;
+    s[4] ^= k1_;
+    return s;
+  }
+
+  static void absorb(State& s, ConstBytes ad) {
+    const std::uint8_t* p = ad.data();
+    std::size_t len = ad.size();
+    if (len) {
+      /* full blocks */
+      for (; len >= Rate; p += Rate, len -= Rate) {
+        s[0] ^= detail::load(p, 8);
+        if (Rate == 16) s[1] ^= detail::load(p + 8, 8);
+        permute<Rounds>(s);
+      }
+      /* final block */
+      std::uint64_t* px = &s[0];
+      if (Rate == 16 && len >= 8) {
+        s[0] ^= detail::load(p, 8);
+        px = &s[1];
+        p += 8;
+        len -= 8;
+      }
+      *px ^= detail::pad(len) ^ detail::load(p, len);
+      permute<Rounds>(s);
+    }
+    /* domain separation */
+    s[4] ^= 1;
+  }
+
+  void finalize(State& s, std::uint8_t* tag) const {
+    s[Rate / 8] ^= k0_;
+    s[Rate / 8 + 1] ^= k1_;
+    permute<12>(s);
+    detail::store(tag, s[3] ^ k0_, 8);
+    detail::store(tag + 8, s[4] ^ k1_, 8);
+  }
+
+  std::uint64_t k0_;
+  std::uint64_t k1_;
+};
+
+using Ascon128 = Aead<8, 6>;
+using Ascon128a = Aead<16, 8>;
+
+static_assert(Ascon128::kIv == ASCON_128_IV, "Ascon-128 iv");
+static_assert(Ascon128a::kIv == ASCON_128A_IV, "Ascon-128a iv");
+
+}  // namespace ascon
+
+#endif /* ASCON_HPP_ */
@@ -0,0 +1,130 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Payload sizes used by the experiment scenarios (1, 5, 50 and 100 readings)
+// plus one large bulk transfer.
+static const size_t bench_sizes[] = {2, 10, 100, 200, 2400};
+#define BENCH_NUM_SIZES (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+
+// Associated data in the same format as send_encrypted_temperature()
+#define BENCH_AD "|TEMP-1|42"
+
+static const unsigned char bench_key[16] = {
+    0x9E, 0x88, 0xCD, 0xDB, 0x2D, 0xA9, 0x09, 0x93,
+    0x7C, 0xAC, 0xD4, 0xD8, 0x02, 0x3F, 0x0D, 0x88
+};
+
+// key_256 of sensor/encryption.c (CHACHA20_POLY1305), bench_key and 16 more bytes
+static const unsigned char bench_key32[32] = {
+    0x9E, 0x88, 0xCD, 0xDB, 0x2D, 0xA9, 0x09, 0x93, 0x7C, 0xAC, 0xD4, 0xD8, 0x02, 0x3F, 0x0D, 0x88,
+    0x5B, 0x1F, 0x2C, 0x7A, 0x91, 0xE4, 0x3D, 0x06, 0xB8, 0x6A, 0xF2, 0x47, 0x0C, 0xD9, 0x83, 0x15
+};
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Time stamp counter ticks. They run at a constant reference rate, not at the
+// core clock, so they are not core cycles. 0 when not on x86.
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Number of iterations that keeps each measurement around a few milliseconds
+static inline int bench_iterations(size_t bytes) {
+    int iterations = (int)(4000000 / (bytes + 64));
+    return iterations < 100 ? 100 : iterations;
+}
+
+static inline void bench_print_header(void) {
+    printf("impl,op,bytes,ns_per_op,tsc_per_byte,mb_per_s\n");
+}
+
+static inline void bench_print_row(const char *impl, const char *op, size_t bytes,
+                                   int iterations, uint64_t ns, uint64_t cycles) {
+    double ns_per_op = (double)ns / iterations;
+    double tsc_per_byte = (double)cycles / iterations / (double)bytes;
+    double mb_per_s = (double)bytes * iterations * 1000.0 / (double)ns;
+    printf("%s,%s,%zu,%.1f,%.2f,%.2f\n", impl, op, bytes, ns_per_op, tsc_per_byte, mb_per_s);
+}
+
+// Latency of single calls, from one bench_now_ns() pair per call
+typedef struct {
+    double mean_ns;
+    double std_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+} bench_latency;
+
+static inline int bench_compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Cost of the bench_now_ns() pair around a call, subtracted from the samples
+static inline uint64_t bench_timer_overhead_ns(void) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t t0 = bench_now_ns(), t1 = bench_now_ns();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+// Sorts the samples, percentiles are nearest-rank
+static inline bench_latency bench_latency_summary(uint64_t *samples, size_t n) {
+    bench_latency latency;
+    double sum = 0, sum_sq = 0;
+    qsort(samples, n, sizeof(samples[0]), bench_compare_u64);
+    for (size_t i = 0; i < n; i++) {
+        sum += (double)samples[i];
+        sum_sq += (double)samples[i] * (double)samples[i];
+    }
+    latency.mean_ns = sum / (double)n;
+    latency.std_ns = n > 1 ? sqrt((sum_sq - sum * latency.mean_ns) / (double)(n - 1)) : 0;
+    latency.p50_ns = samples[(n * 500 + 999) / 1000 - 1];
+    latency.p99_ns = samples[(n * 990 + 999) / 1000 - 1];
+    latency.p999_ns = samples[(n * 999 + 999) / 1000 - 1];
+    return latency;
+}
+
+static inline void bench_print_latency_header(void) {
+    printf("impl,op,bytes,ns_per_op,tsc_per_byte,p50_ns,p99_ns,p999_ns\n");
+}
+
+static inline void bench_print_latency_row(const char *impl, const char *op, size_t bytes,
+                                           int iterations, uint64_t ns, uint64_t cycles,
+                                           const bench_latency *latency) {
+    double ns_per_op = (double)ns / iterations;
+    double tsc_per_byte = (double)cycles / iterations / (double)bytes;
+    printf("%s,%s,%zu,%.1f,%.2f,%llu,%llu,%llu\n", impl, op, bytes, ns_per_op, tsc_per_byte,
+           (unsigned long long)latency->p50_ns, (unsigned long long)latency->p99_ns,
+           (unsigned long long)latency->p999_ns);
+}
+
+static inline void bench_print_hex(const char *label, const unsigned char *data, size_t len) {
+    printf("# %s: ", label);
+    for (size_t i = 0; i < len; i++) {
+        printf("%02X", data[i]);
+    }
+    printf("\n");
+}
+
+#endif // BENCH_H
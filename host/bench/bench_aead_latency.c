@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aead_provider.h"
+#include "bench.h"
+
+// Per-call latency of every provider of aead_providers at the scenario
+// payloads, with the AD of send_encrypted_temperature() ("|TEMP-1|<seq>").
+// Given a directory, it also writes ENC.csv and DEC.csv in the layout of
+// Data analysis/execution_times (mean ± std in ms per scenario and algorithm).
+
+#define LATENCY_SAMPLES 10000
+#define LATENCY_WARMUP 100
+#define LATENCY_SEQ_NUMS 100  // Sequence numbers of the AD, max_packets of a scenario
+#define SCENARIOS 12
+#define SCENARIO_SIZES 4      // Scenario s sends bench_sizes[(s - 1) % 4] bytes (configure_scenario())
+#define MAX_PROVIDERS 8
+
+typedef struct {
+    int measured;
+    bench_latency enc[BENCH_NUM_SIZES];
+    bench_latency dec[BENCH_NUM_SIZES];
+} provider_latency;
+
+// Column names of the execution time tables, the tags of data-storage/main.py
+static const char *provider_tag(uint8_t id) {
+    switch (id) {
+        case ENCRYPTION_ASCON_MASKED: return "masked_ASCON";
+        case ENCRYPTION_ASCON_UNMASKED: return "ASCON";
+        case ENCRYPTION_AES_GCM: return "AES-GCM";
+        case ENCRYPTION_NONE: return "NONE";
+        case ENCRYPTION_ASCON_AEAD128: return "ASCON_AEAD128";
+        case ENCRYPTION_ASCON_AUTH: return "ASCON_AUTH";
+        case ENCRYPTION_CHACHA20_POLY1305: return "CHACHA20-POLY1305";
+        default: return "UNKNOWN";
+    }
+}
+
+static size_t make_ad(char *ad, size_t size, int seq_num) {
+    snprintf(ad, size, "|TEMP-1|%d", seq_num);
+    return strlen(ad);
+}
+
+static int write_table(const char *dir, const char *name, const provider_latency *latency, int encrypt) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    for (size_t i = 0; i < aead_provider_count(); i++) {
+        fprintf(f, ",%s", provider_tag(aead_provider_at(i)->id));
+    }
+    fprintf(f, "\n");
+    for (int scenario = 1; scenario <= SCENARIOS; scenario++) {
+        size_t s = (size_t)(scenario - 1) % SCENARIO_SIZES;
+        fprintf(f, "scen_%d", scenario);
+        for (size_t i = 0; i < aead_provider_count(); i++) {
+            if (!latency[i].measured) {
+                fprintf(f, ",");  // As NONE in the sensor tables
+                continue;
+            }
+            const bench_latency *l = encrypt ? &latency[i].enc[s] : &latency[i].dec[s];
+            fprintf(f, ",%.6f ± %.6f", l->mean_ns / 1e6, l->std_ns / 1e6);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    static provider_latency latency[MAX_PROVIDERS];
+    unsigned char nonce[AEAD_MAX_NONCE_FIELD] = {0};
+    char ad[32];
+    size_t max_len = bench_sizes[BENCH_NUM_SIZES - 1];
+    size_t frame_size = max_len + 16;
+    unsigned char *m = malloc(max_len);
+    unsigned char *c = malloc(frame_size * LATENCY_SEQ_NUMS);
+    size_t *clen = malloc(sizeof(size_t) * LATENCY_SEQ_NUMS);
+    unsigned char *p = malloc(max_len);
+    uint64_t *samples = malloc(sizeof(uint64_t) * LATENCY_SAMPLES);
+    if (!m || !c || !clen || !p || !samples || aead_provider_count() > MAX_PROVIDERS) return 1;
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+
+    uint64_t overhead = bench_timer_overhead_ns();
+    printf("# timer overhead: %llu ns\n", (unsigned long long)overhead);
+    bench_print_latency_header();
+
+    for (size_t i = 0; i < aead_provider_count(); i++) {
+        const aead_provider *provider = aead_provider_at(i);
+        if (!provider->seal) {
+            continue;
+        }
+        provider->setkey(provider->ctx, provider->KeyBytes == (int)sizeof(bench_key32) ? bench_key32 : bench_key);
+
+        for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+            size_t len = bench_sizes[s];
+            int iterations = bench_iterations(len);
+            size_t mlen = 0;
+
+            // Throughput over a loop, as in the other benchmarks
+            uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+            for (int n = 0; n < iterations; n++) {
+                int seq = n % LATENCY_SEQ_NUMS;
+                size_t ad_len = make_ad(ad, sizeof(ad), seq);
+                nonce[0] = (unsigned char)n;
+                provider->seal(provider->ctx, c + seq * frame_size, &clen[seq], m, len,
+                               (const unsigned char *)ad, ad_len, nonce);
+            }
+            uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+            uint64_t enc_ns = t1 - t0, enc_cycles = c1 - c0;
+
+            // One sample per call, the frames of the last LATENCY_SEQ_NUMS calls are kept for decryption
+            for (int n = 0; n < LATENCY_WARMUP + LATENCY_SAMPLES; n++) {
+                int seq = n % LATENCY_SEQ_NUMS;
+                size_t ad_len = make_ad(ad, sizeof(ad), seq);
+                nonce[0] = (unsigned char)seq;
+                t0 = bench_now_ns();
+                provider->seal(provider->ctx, c + seq * frame_size, &clen[seq], m, len,
+                               (const unsigned char *)ad, ad_len, nonce);
+                t1 = bench_now_ns();
+                if (n >= LATENCY_WARMUP) {
+                    samples[n - LATENCY_WARMUP] = t1 - t0 > overhead ? t1 - t0 - overhead : 0;
+                }
+            }
+            latency[i].enc[s] = bench_latency_summary(samples, LATENCY_SAMPLES);
+            bench_print_latency_row(provider->variant_name, "encrypt", len, iterations, enc_ns, enc_cycles,
+                                    &latency[i].enc[s]);
+
+            t0 = bench_now_ns(), c0 = bench_cycles();
+            for (int n = 0; n < iterations; n++) {
+                int seq = n % LATENCY_SEQ_NUMS;
+                size_t ad_len = make_ad(ad, sizeof(ad), seq);
+                nonce[0] = (unsigned char)seq;
+                if (provider->open(provider->ctx, p, &mlen, c + seq * frame_size, clen[seq],
+                                   (const unsigned char *)ad, ad_len, nonce) != 0) {
+                    fprintf(stderr, "%s: decryption failed\n", provider->variant_name);
+                    return 1;
+                }
+            }
+            c1 = bench_cycles(), t1 = bench_now_ns();
+            uint64_t dec_ns = t1 - t0, dec_cycles = c1 - c0;
+
+            for (int n = 0; n < LATENCY_WARMUP + LATENCY_SAMPLES; n++) {
+                int seq = n % LATENCY_SEQ_NUMS;
+                size_t ad_len = make_ad(ad, sizeof(ad), seq);
+                nonce[0] = (unsigned char)seq;
+                t0 = bench_now_ns();
+                provider->open(provider->ctx, p, &mlen, c + seq * frame_size, clen[seq],
+                               (const unsigned char *)ad, ad_len, nonce);
+                t1 = bench_now_ns();
+                if (n >= LATENCY_WARMUP) {
+                    samples[n - LATENCY_WARMUP] = t1 - t0 > overhead ? t1 - t0 - overhead : 0;
+                }
+            }
+            latency[i].dec[s] = bench_latency_summary(samples, LATENCY_SAMPLES);
+            bench_print_latency_row(provider->variant_name, "decrypt", len, iterations, dec_ns, dec_cycles,
+                                    &latency[i].dec[s]);
+        }
+        latency[i].measured = 1;
+    }
+
+    if (argc > 1 && (!write_table(argv[1], "ENC.csv", latency, 1) || !write_table(argv[1], "DEC.csv", latency, 0))) {
+        return 1;
+    }
+
+    free(m);
+    free(c);
+    free(clen);
+    free(p);
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aead_provider.h"
+#include "bench.h"
+
+// Every provider of one binary in turn, through the hooks encrypt() and
+// decrypt() of the sensor use, so the rows compare the modes of a
+// multi-provider image (AEAD_PROVIDERS) under the same conditions
+
+static const unsigned char *provider_key(const aead_provider *provider) {
+    return provider->KeyBytes == (int)sizeof(bench_key32) ? bench_key32 : bench_key;
+}
+
+// open(seal(m)) == m, and a frame with a flipped tag bit is rejected
+static int check_provider(const aead_provider *provider, const unsigned char *m, size_t len,
+                          unsigned char *c, unsigned char *p, const unsigned char *nonce) {
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    size_t ad_len = strlen(BENCH_AD), clen = 0, mlen = 0;
+
+    if (provider->seal(provider->ctx, c, &clen, m, len, ad, ad_len, nonce) != 0 ||
+        clen != len + (size_t)provider->ABytes ||
+        provider->open(provider->ctx, p, &mlen, c, clen, ad, ad_len, nonce) != 0 ||
+        mlen != len || memcmp(p, m, len) != 0) {
+        return 0;
+    }
+    c[clen - 1] ^= 1;
+    return provider->open(provider->ctx, p, &mlen, c, clen, ad, ad_len, nonce) != 0;
+}
+
+int main(void) {
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    size_t ad_len = strlen(BENCH_AD);
+    unsigned char nonce[AEAD_MAX_NONCE_FIELD] = {0};
+    size_t max_len = bench_sizes[BENCH_NUM_SIZES - 1];
+    unsigned char *m = malloc(max_len);
+    unsigned char *c = malloc(max_len + 16);
+    unsigned char *p = malloc(max_len);
+    if (!m || !c || !p) return 1;
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+
+    for (size_t i = 0; i < aead_provider_count(); i++) {
+        const aead_provider *provider = aead_provider_at(i);
+        if (provider->setkey) {
+            provider->setkey(provider->ctx, provider_key(provider));
+        }
+        if (aead_provider_find(provider->id) != provider) {
+            fprintf(stderr, "%s: id %d not found\n", provider->variant_name, provider->id);
+            return 1;
+        }
+        if (!provider->seal) {
+            continue;
+        }
+        for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+            if (!check_provider(provider, m, bench_sizes[s], c, p, nonce)) {
+                fprintf(stderr, "%s: round trip failed at %zu bytes\n", provider->variant_name, bench_sizes[s]);
+                return 1;
+            }
+        }
+
+        // Reference frame, the same as the one of the library's own bench
+        char label[64];
+        size_t clen = 0;
+        provider->seal(provider->ctx, c, &clen, m, 2, ad, ad_len, nonce);
+        snprintf(label, sizeof(label), "%s scenario 1 frame", provider->variant_name);
+        bench_print_hex(label, c, clen);
+    }
+
+    bench_print_header();
+    for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+        size_t len = bench_sizes[s];
+        int iterations = bench_iterations(len);
+
+        // All providers at one size before the next size, like a rotating image
+        for (size_t i = 0; i < aead_provider_count(); i++) {
+            const aead_provider *provider = aead_provider_at(i);
+            size_t clen = 0, mlen = 0;
+            if (!provider->seal) {
+                continue;
+            }
+
+            uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+            for (int n = 0; n < iterations; n++) {
+                nonce[0] = (unsigned char)n;
+                provider->seal(provider->ctx, c, &clen, m, len, ad, ad_len, nonce);
+            }
+            uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+            bench_print_row(provider->variant_name, "encrypt", len, iterations, t1 - t0, c1 - c0);
+
+            t0 = bench_now_ns(), c0 = bench_cycles();
+            for (int n = 0; n < iterations; n++) {
+                if (provider->open(provider->ctx, p, &mlen, c, clen, ad, ad_len, nonce) != 0) {
+                    fprintf(stderr, "%s: decryption failed\n", provider->variant_name);
+                    return 1;
+                }
+            }
+            c1 = bench_cycles(), t1 = bench_now_ns();
+            bench_print_row(provider->variant_name, "decrypt", len, iterations, t1 - t0, c1 - c0);
+        }
+    }
+
+    free(m);
+    free(c);
+    free(p);
+    return 0;
+}
@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "api.h"
+#include "crypto_aead.h"
+#include "gcm.h"
+#include "bench.h"
+
+#if defined(MBEDTLS_AES_ROM_TABLES)
+#define TABLES_NAME "-rom"
+#else
+#define TABLES_NAME ""
+#endif
+
+#if defined(MBEDTLS_AESNI_C)
+#define IMPL_NAME "aes-gcm-aesni"
+#elif defined(MBEDTLS_AES_FIXSLICED)
+#define IMPL_NAME "aes-gcm-fixsliced"
+#elif defined(MBEDTLS_AES_FULL_TABLES)
+#define IMPL_NAME "aes-gcm" TABLES_NAME "-full"
+#else
+#define IMPL_NAME "aes-gcm" TABLES_NAME
+#endif
+
+// SP 800-38D test cases 1 and 2 (McGrew/Viega): zero key and 12 byte IV,
+// empty message, then one zero block
+static const unsigned char kat_frame[2][32] = {
+    {0x58, 0xE2, 0xFC, 0xCE, 0xFA, 0x7E, 0x30, 0x61, 0x36, 0x7F, 0x1D, 0x57,
+     0xA4, 0xE7, 0x45, 0x5A},
+    {0x03, 0x88, 0xDA, 0xCE, 0x60, 0xB6, 0xA3, 0x92, 0xF3, 0x28, 0xC2, 0xB9,
+     0x71, 0xB2, 0xFE, 0x78, 0xAB, 0x6E, 0x47, 0xD4, 0x2C, 0xEC, 0x13, 0xBD,
+     0xF5, 0x3A, 0x67, 0xB2, 0x12, 0x57, 0xBD, 0xDF}
+};
+
+// FIPS-197 appendix C.1, AES-128
+static const unsigned char kat_aes_key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                              0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+static const unsigned char kat_aes_in[16] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                             0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+static const unsigned char kat_aes_out[16] = {0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+                                              0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A};
+
+static int check_aes(void) {
+    nbedtls_aes_context aes;
+    unsigned char out0[16], out1[16], zero[16] = {0};
+    nbedtls_aes_init(&aes);
+    nbedtls_aes_setkey_enc(&aes, kat_aes_key, 128);
+    nbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, kat_aes_in, out0);
+    int ok = memcmp(out0, kat_aes_out, 16) == 0;
+    // Both slots of the two block call, in either order
+    nbedtls_aes_crypt_ecb2(&aes, kat_aes_in, zero, out0, out1);
+    ok = ok && memcmp(out0, kat_aes_out, 16) == 0;
+    nbedtls_aes_crypt_ecb2(&aes, zero, kat_aes_in, out0, out1);
+    ok = ok && memcmp(out1, kat_aes_out, 16) == 0;
+    nbedtls_aes_free(&aes);
+    return ok;
+}
+
+// Tag of the largest bench frame (bench_key, BENCH_AD, zero nonce,
+// m[i] = i), the same with the table, fixsliced and AES-NI code. Covers the
+// multi-block CTR paths that the one block test cases do not reach.
+static const unsigned char kat_bulk_tag[16] = {0x0E, 0x40, 0xDC, 0x4B, 0x58, 0x8C, 0xB3, 0x29,
+                                               0xD0, 0x4B, 0x41, 0x02, 0xFF, 0x6F, 0x5D, 0xD4};
+
+static int check_kat(const unsigned char *m, size_t max_len) {
+    unsigned char k[16] = {0}, n[CRYPTO_NPUBBYTES] = {0}, z[16] = {0}, c[32];
+    unsigned long long clen;
+    crypto_aead_encrypt(c, &clen, NULL, 0, NULL, 0, NULL, n, k);
+    if (clen != 16 || memcmp(c, kat_frame[0], 16) != 0) return 0;
+    crypto_aead_encrypt(c, &clen, z, 16, NULL, 0, NULL, n, k);
+    if (clen != 32 || memcmp(c, kat_frame[1], 32) != 0) return 0;
+
+    unsigned char *cb = malloc(max_len + CRYPTO_ABYTES);
+    if (!cb) return 0;
+    crypto_aead_encrypt(cb, &clen, m, max_len, (const unsigned char *)BENCH_AD, strlen(BENCH_AD),
+                        NULL, n, bench_key);
+    int ok = clen == max_len + CRYPTO_ABYTES && memcmp(cb + max_len, kat_bulk_tag, 16) == 0;
+    free(cb);
+    return ok;
+}
+
+// The keyed context must match the one-shot functions frame after frame,
+// and reject a forged tag without breaking the next frame
+static int check_keyed(const unsigned char *m, size_t max_len) {
+    nbedtls_gcm_aead_context key;
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {0};
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    size_t ad_len = strlen(BENCH_AD);
+    unsigned char *c = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *ck = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *p = malloc(max_len + CRYPTO_ABYTES);
+    int ok = c && ck && p;
+    nbedtls_gcm_aead_setkey(&key, bench_key);
+    for (size_t s = 0; ok && s < BENCH_NUM_SIZES; s++) {
+        size_t len = bench_sizes[s];
+        unsigned long long clen, cklen, plen;
+        nonce[0] = (unsigned char)s;
+        crypto_aead_encrypt(c, &clen, m, len, ad, ad_len, NULL, nonce, bench_key);
+        nbedtls_gcm_aead_seal(&key, ck, &cklen, m, len, ad, ad_len, nonce);
+        ok = cklen == clen && memcmp(ck, c, (size_t)clen) == 0;
+        ck[cklen - 1] ^= 1;
+        ok = ok && nbedtls_gcm_aead_open(&key, p, &plen, ck, cklen, ad, ad_len, nonce) ==
+                       MBEDTLS_ERR_GCM_AUTH_FAILED;
+        ok = ok && nbedtls_gcm_aead_open(&key, p, &plen, c, clen, ad, ad_len, nonce) == 0 &&
+             plen == len && memcmp(p, m, len) == 0;
+
+        // The precomputed keystream gives the same frame, and refuses a
+        // payload longer than it
+        nbedtls_gcm_aead_precomp pre;
+        size_t pre_len = len < MBEDTLS_GCM_AEAD_PRECOMP_BYTES ? len : MBEDTLS_GCM_AEAD_PRECOMP_BYTES;
+        ok = ok && nbedtls_gcm_aead_precompute(&key, &pre, nonce, pre_len) == 0;
+        if (len > pre_len) {
+            ok = ok && nbedtls_gcm_aead_seal_precomp(&key, &pre, ck, &cklen, m, len, ad, ad_len) ==
+                           MBEDTLS_ERR_GCM_BAD_INPUT;
+        } else {
+            ok = ok && nbedtls_gcm_aead_seal_precomp(&key, &pre, ck, &cklen, m, len, ad, ad_len) == 0 &&
+                 cklen == clen && memcmp(ck, c, (size_t)clen) == 0;
+        }
+    }
+    nbedtls_gcm_aead_free(&key);
+    free(c);
+    free(ck);
+    free(p);
+    return ok;
+}
+
+#define BENCH_PRECOMP_BATCH 64
+static nbedtls_gcm_aead_precomp precomp[BENCH_PRECOMP_BATCH];
+
+int main(void) {
+    // The first key setup of the process also generates the RAM tables, as
+    // the first encrypt() after boot does on the sensor
+    nbedtls_gcm_aead_context key;
+    uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+    nbedtls_gcm_aead_setkey(&key, bench_key);
+    uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+    uint64_t first_ns = t1 - t0, first_cycles = c1 - c0;
+
+    size_t max_len = bench_sizes[BENCH_NUM_SIZES - 1];
+    unsigned char *m = malloc(max_len);
+    unsigned char *c = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *p = malloc(max_len + CRYPTO_ABYTES);
+    if (!m || !c || !p) return 1;
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+
+    if (!check_aes() || !check_kat(m, max_len) || !check_keyed(m, max_len)) {
+        fprintf(stderr, "%s: known answer test failed\n", IMPL_NAME);
+        return 1;
+    }
+
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    size_t ad_len = strlen(BENCH_AD);
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {0};
+    unsigned long long clen, mlen;
+
+    bench_print_header();
+    bench_print_row(IMPL_NAME, "setkey_first", 16, 1, first_ns, first_cycles);
+
+    int iterations = bench_iterations(16);
+    t0 = bench_now_ns(), c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        nbedtls_gcm_aead_setkey(&key, bench_key);
+    }
+    c1 = bench_cycles(), t1 = bench_now_ns();
+    bench_print_row(IMPL_NAME, "setkey", 16, iterations, t1 - t0, c1 - c0);
+
+    // One AES block with the round keys of the keyed context, chained so
+    // every block depends on the previous one
+    unsigned char block[16] = {0};
+    t0 = bench_now_ns(), c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        nbedtls_aes_crypt_ecb(&key.aes, MBEDTLS_AES_ENCRYPT, block, block);
+    }
+    c1 = bench_cycles(), t1 = bench_now_ns();
+    bench_print_row(IMPL_NAME, "block", 16, iterations, t1 - t0, c1 - c0);
+
+    // Two blocks per call, as the CTR loop of GCM does
+    unsigned char block2[16] = {0};
+    t0 = bench_now_ns(), c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        nbedtls_aes_crypt_ecb2(&key.aes, block, block2, block, block2);
+    }
+    c1 = bench_cycles(), t1 = bench_now_ns();
+    bench_print_row(IMPL_NAME, "block2", 32, iterations, t1 - t0, c1 - c0);
+
+    for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+        size_t len = bench_sizes[s];
+        iterations = bench_iterations(len);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            crypto_aead_encrypt(c, &clen, m, len, ad, ad_len, NULL, nonce, bench_key);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "encrypt", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            if (crypto_aead_decrypt(p, &mlen, NULL, c, clen, ad, ad_len, nonce, bench_key) != 0) {
+                fprintf(stderr, "%s: decryption failed\n", IMPL_NAME);
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "decrypt", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            nbedtls_gcm_aead_seal(&key, c, &clen, m, len, ad, ad_len, nonce);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "encrypt_keyed", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            if (nbedtls_gcm_aead_open(&key, p, &mlen, c, clen, ad, ad_len, nonce) != 0) {
+                fprintf(stderr, "%s: keyed decryption failed\n", IMPL_NAME);
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "decrypt_keyed", len, iterations, t1 - t0, c1 - c0);
+
+        if (len <= MBEDTLS_GCM_AEAD_PRECOMP_BYTES) {
+            // The AES blocks ahead of time (precompute), and what is left
+            // once the payload is there (encrypt_precomp), in batches of
+            // BENCH_PRECOMP_BATCH nonces
+            uint64_t pre_ns = 0, pre_cycles = 0, seal_ns = 0, seal_cycles = 0;
+            int n = 0;
+            while (n < iterations) {
+                t0 = bench_now_ns(), c0 = bench_cycles();
+                for (int b = 0; b < BENCH_PRECOMP_BATCH; b++) {
+                    nonce[0] = (unsigned char)(n + b);
+                    nbedtls_gcm_aead_precompute(&key, &precomp[b], nonce, len);
+                }
+                c1 = bench_cycles(), t1 = bench_now_ns();
+                pre_ns += t1 - t0, pre_cycles += c1 - c0;
+
+                t0 = bench_now_ns(), c0 = bench_cycles();
+                for (int b = 0; b < BENCH_PRECOMP_BATCH; b++) {
+                    nbedtls_gcm_aead_seal_precomp(&key, &precomp[b], c, &clen, m, len, ad, ad_len);
+                }
+                c1 = bench_cycles(), t1 = bench_now_ns();
+                seal_ns += t1 - t0, seal_cycles += c1 - c0;
+                n += BENCH_PRECOMP_BATCH;
+            }
+            bench_print_row(IMPL_NAME, "precompute", len, n, pre_ns, pre_cycles);
+            bench_print_row(IMPL_NAME, "encrypt_precomp", len, n, seal_ns, seal_cycles);
+        }
+    }
+
+    nbedtls_gcm_aead_free(&key);
+    free(m);
+    free(c);
+    free(p);
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "api.h"
+#include "ascon.h"
+#include "config.h"
+#include "crypto_aead.h"
+#include "bench.h"
+
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+#define VARIANT_NAME "ascon-aead128"
+#elif ASCON_FIXED_KERNELS
+#define VARIANT_NAME "ascon-fixed"
+#else
+#define VARIANT_NAME "ascon"
+#endif
+
+#if ASCON_BACKEND == ASCON_BACKEND_OPT64
+#define BACKEND_NAME VARIANT_NAME "-opt64"
+#elif ASCON_BACKEND == ASCON_BACKEND_BI32
+#define BACKEND_NAME VARIANT_NAME "-bi32"
+#else
+#define BACKEND_NAME VARIANT_NAME "-armv6m"
+#endif
+
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+// SP 800-232 Ascon-AEAD128 known answers: key = 00..0F, nonce = 10..1F.
+// Empty AD and message (LWC KAT count 1), then AD = 30..39 and message =
+// 00..13, which covers partial and full blocks.
+static const unsigned char kat_frame[2][36] = {
+    {0x4F, 0x9C, 0x27, 0x82, 0x11, 0xBE, 0xC9, 0x31, 0x6B, 0xF6, 0x8F, 0x46,
+     0xEE, 0x8B, 0x2E, 0xC6},
+    {0x32, 0x24, 0x09, 0xB6, 0xFA, 0x62, 0x94, 0x73, 0x4E, 0x7A, 0x7F, 0x9C,
+     0x3D, 0xBB, 0x03, 0x06, 0xE2, 0x05, 0xF1, 0x77, 0x5C, 0x8D, 0xEB, 0x5F,
+     0x0D, 0x0E, 0xE6, 0xB6, 0x9E, 0x5A, 0xC0, 0x5C, 0x18, 0x31, 0xC7, 0x6A}
+};
+
+static int check_kat(void) {
+    unsigned char k[16], n[16], ad[10], m[20], c[36];
+    unsigned long long clen;
+    for (int i = 0; i < 16; i++) k[i] = (unsigned char)i, n[i] = (unsigned char)(16 + i);
+    for (int i = 0; i < 10; i++) ad[i] = (unsigned char)(0x30 + i);
+    for (int i = 0; i < 20; i++) m[i] = (unsigned char)i;
+    crypto_aead_encrypt(c, &clen, NULL, 0, NULL, 0, NULL, n, k);
+    if (clen != 16 || memcmp(c, kat_frame[0], 16) != 0) return 0;
+    crypto_aead_encrypt(c, &clen, m, 20, ad, 10, NULL, n, k);
+    return clen == 36 && memcmp(c, kat_frame[1], 36) == 0;
+}
+#else
+// Ascon-128a v1.2 known answer: key = nonce = 00..0F, empty AD and message
+static const unsigned char kat_tag[16] = {
+    0x7A, 0x83, 0x4E, 0x6F, 0x09, 0x21, 0x09, 0x57,
+    0x06, 0x7B, 0x10, 0xFD, 0x83, 0x1F, 0x00, 0x78
+};
+
+static int check_kat(void) {
+    unsigned char k[16], n[16], c[CRYPTO_ABYTES];
+    unsigned long long clen;
+    for (int i = 0; i < 16; i++) k[i] = n[i] = (unsigned char)i;
+    crypto_aead_encrypt(c, &clen, NULL, 0, NULL, 0, NULL, n, k);
+    return clen == CRYPTO_ABYTES && memcmp(c, kat_tag, CRYPTO_ABYTES) == 0;
+}
+#endif
+
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+// Sessions are specified on top of Ascon-128a only (see ascon_session.py)
+static int check_session(void) {
+    return 1;
+}
+#else
+// Session frames, key 00..0F, nonce 10..1F: empty message with header
+// "R|TEMP-1|0", then message 00 01 with header "S|TEMP-1|1"
+static const unsigned char kat_session[2][18] = {
+    {0x3F, 0x8C, 0x20, 0x6D, 0x0A, 0x34, 0x4F, 0xB0, 0x6A, 0x5A, 0xDC, 0x6F,
+     0xFB, 0x2E, 0x25, 0xE6},
+    {0x61, 0xE5, 0xE1, 0xB6, 0x99, 0x38, 0xAD, 0xD6, 0xEE, 0xF2, 0x06, 0x00,
+     0x45, 0x1B, 0xDB, 0x6C, 0x00, 0x88}
+};
+
+static int check_session(void) {
+    unsigned char k[16], n[16], m[2] = {0, 1}, c[18];
+    uint64_t clen;
+    ascon_aead_keyctx_t key;
+    ascon_session_t session;
+    for (int i = 0; i < 16; i++) k[i] = (unsigned char)i, n[i] = (unsigned char)(16 + i);
+    ascon_aead_setkey(&key, k);
+    ascon_session_init(&session, &key, n);
+    ascon_session_seal(&session, c, &clen, NULL, 0, (const unsigned char *)"R|TEMP-1|0", 10);
+    if (clen != 16 || memcmp(c, kat_session[0], 16) != 0) return 0;
+    ascon_session_seal(&session, c, &clen, m, 2, (const unsigned char *)"S|TEMP-1|1", 10);
+    return clen == 18 && memcmp(c, kat_session[1], 18) == 0;
+}
+#endif
+
+// Size of the BLE chunks used by send_next_chunk()
+#define BENCH_CHUNK 200
+
+// Encrypts m in chunks of chunk bytes with the incremental API, returns clen
+static size_t stream_encrypt(unsigned char *c, const unsigned char *m, size_t len, size_t chunk,
+                             const unsigned char *ad, size_t ad_len, const unsigned char *nonce) {
+    ascon_aead_ctx_t ctx;
+    size_t clen = 0;
+    ascon_aead_init(&ctx, nonce, bench_key);
+    ascon_aead_absorb(&ctx, ad, ad_len / 2);
+    ascon_aead_absorb(&ctx, ad + ad_len / 2, ad_len - ad_len / 2);
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = (len - off < chunk) ? len - off : chunk;
+        clen += ascon_aead_encrypt_update(&ctx, c + clen, m + off, n);
+    }
+    clen += ascon_aead_encrypt_final(&ctx, c + clen, c + len);
+    return clen + CRYPTO_ABYTES;
+}
+
+// Incremental encryption and decryption must match the one-shot API for any chunking
+static int check_stream(const unsigned char *m, size_t max_len) {
+    static const size_t chunks[] = {1, 7, 16, 33, BENCH_CHUNK};
+    static const size_t ad_lens[] = {0, 10, 16, 32};
+    const unsigned char *ad = m + 1;
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {1};
+    unsigned char *c = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *sc = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *p = malloc(max_len);
+    int ok = c && sc && p;
+    for (size_t s = 0; ok && s < BENCH_NUM_SIZES; s++) {
+        for (size_t a = 0; ok && a < sizeof(ad_lens) / sizeof(ad_lens[0]); a++) {
+            size_t len = bench_sizes[s];
+            size_t ad_len = ad_lens[a];
+            unsigned long long clen;
+            crypto_aead_encrypt(c, &clen, m, len, ad, ad_len, NULL, nonce, bench_key);
+            for (size_t k = 0; ok && k < sizeof(chunks) / sizeof(chunks[0]); k++) {
+                ascon_aead_ctx_t ctx;
+                uint64_t plen = 0, tail;
+                if (stream_encrypt(sc, m, len, chunks[k], ad, ad_len, nonce) != clen ||
+                    memcmp(sc, c, (size_t)clen) != 0) {
+                    ok = 0;
+                    break;
+                }
+                ascon_aead_init(&ctx, nonce, bench_key);
+                ascon_aead_absorb(&ctx, ad, ad_len);
+                for (size_t off = 0; off < len; off += chunks[k]) {
+                    size_t n = (len - off < chunks[k]) ? len - off : chunks[k];
+                    plen += ascon_aead_decrypt_update(&ctx, p + plen, c + off, n);
+                }
+                if (ascon_aead_decrypt_final(&ctx, p + plen, &tail, c + len) != 0 ||
+                    plen + tail != len || memcmp(p, m, len) != 0) {
+                    ok = 0;
+                }
+            }
+        }
+    }
+    free(c);
+    free(sc);
+    free(p);
+    return ok;
+}
+
+int main(void) {
+    if (!check_kat() || !check_session()) {
+        fprintf(stderr, "%s: known answer test failed\n", BACKEND_NAME);
+        return 1;
+    }
+
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    unsigned long long ad_len = strlen(BENCH_AD);
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {0};
+    size_t max_len = bench_sizes[BENCH_NUM_SIZES - 1];
+    unsigned char *m = malloc(max_len);
+    unsigned char *c = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *p = malloc(max_len);
+    if (!m || !c || !p) return 1;
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+    if (!check_stream(m, max_len)) {
+        fprintf(stderr, "%s: incremental API differs from crypto_aead_encrypt\n", BACKEND_NAME);
+        return 1;
+    }
+
+    // Reference frame, byte comparable with a sensor build using the same inputs
+    unsigned long long clen, mlen;
+    crypto_aead_encrypt(c, &clen, m, 2, ad, ad_len, NULL, nonce, bench_key);
+    bench_print_hex("scenario 1 frame", c, (size_t)clen);
+
+    // Keyed context as used by encrypt() on the sensor, key loaded once
+    ascon_aead_keyctx_t key;
+    uint64_t keyed_len;
+    ascon_aead_setkey(&key, bench_key);
+    ascon_aead_seal(&key, p, &keyed_len, m, 2, ad, ad_len, nonce);
+    if (keyed_len != clen || memcmp(p, c, (size_t)clen) != 0) {
+        fprintf(stderr, "%s: keyed context differs from crypto_aead_encrypt\n", BACKEND_NAME);
+        return 1;
+    }
+
+    bench_print_header();
+    for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+        size_t len = bench_sizes[s];
+        int iterations = bench_iterations(len);
+
+        uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            crypto_aead_encrypt(c, &clen, m, len, ad, ad_len, NULL, nonce, bench_key);
+        }
+        uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "encrypt", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            if (crypto_aead_decrypt(p, &mlen, NULL, c, clen, ad, ad_len, nonce, bench_key) != 0) {
+                fprintf(stderr, "%s: decryption failed\n", BACKEND_NAME);
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "decrypt", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            stream_encrypt(c, m, len, BENCH_CHUNK, ad, ad_len, nonce);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "encrypt_stream", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            ascon_aead_seal(&key, c, &keyed_len, m, len, ad, ad_len, nonce);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "encrypt_keyed", len, iterations, t1 - t0, c1 - c0);
+
+        // Session frames as sent by the sensor, the state carries over between iterations
+        ascon_session_t session;
+        uint64_t plen;
+        ascon_session_init(&session, &key, nonce);
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            ascon_session_seal(&session, c, &keyed_len, m, len, ad, ad_len);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "session_seal", len, iterations, t1 - t0, c1 - c0);
+
+        // A valid open advances the state, so every iteration restores the
+        // receiving state the frame was sealed against (a 40 byte copy)
+        ascon_session_t rx_start;
+        ascon_session_init(&session, &key, nonce);
+        rx_start = session;
+        ascon_session_seal(&session, c, &keyed_len, m, len, ad, ad_len);
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            session = rx_start;
+            if (ascon_session_open(&session, p, &plen, c, keyed_len, ad, ad_len) != 0) {
+                fprintf(stderr, "%s: session open failed\n", BACKEND_NAME);
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "session_open", len, iterations, t1 - t0, c1 - c0);
+    }
+
+    free(m);
+    free(c);
+    free(p);
+    return 0;
+}
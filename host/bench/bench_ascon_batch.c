@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "api.h"
+#include "ascon_batch.h"
+#include "crypto_aead.h"
+#include "bench.h"
+
+#define BATCH_FRAMES 1024
+
+// Frames as received by the storage side: one nonce per frame, AD with the sequence number
+typedef struct {
+    unsigned char nonce[CRYPTO_NPUBBYTES];
+    char ad[32];
+    unsigned char *c;
+    unsigned char *p;
+    unsigned long long clen;
+} bench_frame_t;
+
+static void make_frame(bench_frame_t *f, int seq, size_t len, const unsigned char *m) {
+    memset(f->nonce, 0, sizeof(f->nonce));
+    memcpy(f->nonce, &seq, sizeof(seq));
+    snprintf(f->ad, sizeof(f->ad), "|TEMP-1|%d", seq);
+    crypto_aead_encrypt(f->c, &f->clen, m, len, (const unsigned char *)f->ad, strlen(f->ad),
+                        NULL, f->nonce, bench_key);
+}
+
+static void to_batch(const bench_frame_t *f, ascon_frame_t *b) {
+    b->m = f->p;
+    b->c = f->c;
+    b->clen = f->clen;
+    b->ad = (const unsigned char *)f->ad;
+    b->adlen = strlen(f->ad);
+    b->npub = f->nonce;
+    b->k = bench_key;
+    b->result = 1;
+}
+
+// Mixed payload sizes with some forged frames, compared against crypto_aead_decrypt
+static int check_batch(bench_frame_t *frames, ascon_frame_t *batch, const unsigned char *m) {
+    unsigned char *p = malloc(bench_sizes[BENCH_NUM_SIZES - 1]);
+    size_t expected_failed = 0;
+    int ok = p != NULL;
+    for (int i = 0; i < BATCH_FRAMES; i++) {
+        make_frame(&frames[i], i, bench_sizes[(i * 7) % BENCH_NUM_SIZES], m);
+        if (i % 13 == 5) {
+            frames[i].c[(size_t)i % frames[i].clen] ^= 0x01;
+            expected_failed++;
+        }
+        to_batch(&frames[i], &batch[i]);
+    }
+    if (ok && ascon_aead_decrypt_batch(BATCH_FRAMES, batch) != expected_failed) ok = 0;
+    for (int i = 0; ok && i < BATCH_FRAMES; i++) {
+        unsigned long long mlen;
+        int result = crypto_aead_decrypt(p, &mlen, NULL, frames[i].c, frames[i].clen,
+                                         batch[i].ad, batch[i].adlen, frames[i].nonce, bench_key);
+        if (result != batch[i].result || mlen != batch[i].mlen ||
+            memcmp(p, frames[i].p, (size_t)mlen) != 0) {
+            ok = 0;
+        }
+    }
+    free(p);
+    return ok;
+}
+
+int main(void) {
+    size_t max_len = bench_sizes[BENCH_NUM_SIZES - 1];
+    unsigned char *m = malloc(max_len);
+    bench_frame_t *frames = calloc(BATCH_FRAMES, sizeof(*frames));
+    ascon_frame_t *batch = calloc(BATCH_FRAMES, sizeof(*batch));
+    if (!m || !frames || !batch) return 1;
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+    for (int i = 0; i < BATCH_FRAMES; i++) {
+        frames[i].c = malloc(max_len + CRYPTO_ABYTES);
+        frames[i].p = malloc(max_len);
+        if (!frames[i].c || !frames[i].p) return 1;
+    }
+
+    if (!check_batch(frames, batch, m)) {
+        fprintf(stderr, "ascon-batch: result differs from crypto_aead_decrypt\n");
+        return 1;
+    }
+    printf("# lanes: %d\n", ascon_batch_lanes());
+
+    bench_print_header();
+    for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+        size_t len = bench_sizes[s];
+        int rounds = bench_iterations(len) / BATCH_FRAMES + 1;
+        int iterations = rounds * BATCH_FRAMES;
+        for (int i = 0; i < BATCH_FRAMES; i++) {
+            make_frame(&frames[i], i, len, m);
+            to_batch(&frames[i], &batch[i]);
+        }
+
+        uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < BATCH_FRAMES; i++) {
+                unsigned long long mlen;
+                if (crypto_aead_decrypt(frames[i].p, &mlen, NULL, frames[i].c, frames[i].clen,
+                                        batch[i].ad, batch[i].adlen, frames[i].nonce,
+                                        bench_key) != 0) {
+                    fprintf(stderr, "ascon-opt64: decryption failed\n");
+                    return 1;
+                }
+            }
+        }
+        uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row("ascon-opt64", "decrypt", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int r = 0; r < rounds; r++) {
+            if (ascon_aead_decrypt_batch(BATCH_FRAMES, batch) != 0) {
+                fprintf(stderr, "ascon-batch: decryption failed\n");
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row("ascon-batch", "decrypt", len, iterations, t1 - t0, c1 - c0);
+    }
+
+    for (int i = 0; i < BATCH_FRAMES; i++) {
+        free(frames[i].c);
+        free(frames[i].p);
+    }
+    free(frames);
+    free(batch);
+    free(m);
+    return 0;
+}
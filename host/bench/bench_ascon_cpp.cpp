@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ascon.hpp"
+
+extern "C" {
+#include "api.h"
+#include "ascon.h"
+#include "crypto_aead.h"
+}
+
+#include "bench.h"
+
+#define CPP_NAME "ascon-cpp"
+#define C_NAME "ascon-opt64"
+
+// Ascon-128 v1.2 known answers: key = nonce = 00..0F, empty AD and message,
+// then AD = 00..0A and message = 00..14
+static const unsigned char kat_128[2][37] = {
+    {0xE3, 0x55, 0x15, 0x9F, 0x29, 0x29, 0x11, 0xF7, 0x94, 0xCB, 0x14, 0x32,
+     0xA0, 0x10, 0x3A, 0x8A},
+    {0x76, 0x80, 0x7B, 0x64, 0x48, 0x89, 0x6C, 0xE5, 0x88, 0x42, 0xCB, 0x4A,
+     0xED, 0x6C, 0x41, 0x04, 0x1D, 0x6D, 0xEC, 0x3B, 0x3A, 0xC9, 0xC6, 0xCD,
+     0x10, 0x0C, 0x70, 0x39, 0x3C, 0x11, 0x9B, 0x15, 0x99, 0x17, 0x85, 0x27,
+     0x4D}
+};
+
+static bool check_kat_128() {
+    unsigned char k[16], ad[11], m[21], c[37];
+    for (int i = 0; i < 21; i++) m[i] = (unsigned char)i;
+    for (int i = 0; i < 16; i++) k[i] = (unsigned char)i;
+    for (int i = 0; i < 11; i++) ad[i] = (unsigned char)i;
+    ascon::Ascon128 aead(k);
+    aead.seal(c, ascon::ConstBytes(), ascon::ConstBytes(), k);
+    if (memcmp(c, kat_128[0], 16) != 0) return false;
+    aead.seal(c, ascon::ConstBytes(m, 21), ascon::ConstBytes(ad, 11), k);
+    return memcmp(c, kat_128[1], 37) == 0;
+}
+
+// Ascon-128a must be bit-exact with crypto_aead_encrypt for every payload
+// size and for AD and message lengths around the block boundaries
+static bool check_c(const unsigned char *m, size_t max_len) {
+    static const size_t lens[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33};
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {7};
+    std::vector<unsigned char> c(max_len + CRYPTO_ABYTES), cc(max_len + CRYPTO_ABYTES);
+    std::vector<unsigned char> p(max_len + CRYPTO_ABYTES);
+    ascon::Ascon128a aead(bench_key);
+    std::vector<size_t> sizes(lens, lens + sizeof(lens) / sizeof(lens[0]));
+    sizes.insert(sizes.end(), bench_sizes, bench_sizes + BENCH_NUM_SIZES);
+    for (size_t len : sizes) {
+        for (size_t ad_len : lens) {
+            unsigned long long clen;
+            crypto_aead_encrypt(c.data(), &clen, m, len, m + 3, ad_len, NULL, nonce, bench_key);
+            aead.seal(cc.data(), ascon::ConstBytes(m, len), ascon::ConstBytes(m + 3, ad_len), nonce);
+            if (memcmp(cc.data(), c.data(), (size_t)clen) != 0) return false;
+            // In place round trip, then a forged tag must fail and wipe the output
+            if (!aead.open(cc.data(), ascon::ConstBytes(cc.data(), (size_t)clen),
+                           ascon::ConstBytes(m + 3, ad_len), nonce) ||
+                memcmp(cc.data(), m, len) != 0) {
+                return false;
+            }
+            c[clen - 1] ^= 1;
+            if (aead.open(p.data(), ascon::ConstBytes(c.data(), (size_t)clen),
+                          ascon::ConstBytes(m + 3, ad_len), nonce)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    size_t max_len = bench_sizes[BENCH_NUM_SIZES - 1];
+    std::vector<unsigned char> m(max_len), c(max_len + CRYPTO_ABYTES), p(max_len);
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+    if (!check_kat_128() || !check_c(m.data(), max_len)) {
+        fprintf(stderr, "%s: known answer test failed\n", CPP_NAME);
+        return 1;
+    }
+
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    ascon::ConstBytes ad_view(ad, strlen(BENCH_AD));
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {0};
+    unsigned char tag[CRYPTO_ABYTES];
+    ascon::Ascon128a aead(bench_key);
+    ascon_aead_keyctx_t key;
+    ascon_aead_setkey(&key, bench_key);
+
+    bench_print_header();
+    for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+        size_t len = bench_sizes[s];
+        int iterations = bench_iterations(len);
+        ascon::Bytes data(c.data(), len);
+
+        // In place, the buffer is encrypted over and over
+        uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            aead.encrypt(data, ad_view, nonce, tag);
+        }
+        uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(CPP_NAME, "encrypt", len, iterations, t1 - t0, c1 - c0);
+
+        memcpy(c.data(), m.data(), len);
+        aead.encrypt(data, ad_view, nonce, tag);
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            // Decrypt and encrypt back, so every iteration sees a valid frame
+            if (!aead.decrypt(data, ad_view, nonce, tag)) {
+                fprintf(stderr, "%s: decryption failed\n", CPP_NAME);
+                return 1;
+            }
+            aead.encrypt(data, ad_view, nonce, tag);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(CPP_NAME, "decrypt_encrypt", len, iterations, t1 - t0, c1 - c0);
+
+        // The C build with the key loaded once, same inputs
+        uint64_t clen, mlen;
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            ascon_aead_seal(&key, c.data(), &clen, m.data(), len, ad, ad_view.size(), nonce);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(C_NAME, "encrypt_keyed", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            if (ascon_aead_open(&key, p.data(), &mlen, c.data(), clen, ad, ad_view.size(), nonce) != 0) {
+                fprintf(stderr, "%s: decryption failed\n", C_NAME);
+                return 1;
+            }
+            ascon_aead_seal(&key, c.data(), &clen, p.data(), len, ad, ad_view.size(), nonce);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(C_NAME, "decrypt_encrypt", len, iterations, t1 - t0, c1 - c0);
+    }
+    return 0;
+}
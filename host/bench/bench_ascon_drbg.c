@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+
+#include "ascon.h"
+#include "bench.h"
+
+#if ASCON_BACKEND == ASCON_BACKEND_BI32
+#define BACKEND_NAME "ascon-drbg-bi32"
+#else
+#define BACKEND_NAME "ascon-drbg-opt64"
+#endif
+
+// Nonce source of the sensor before and after NONCE_DRBG: getrandom() stands
+// in for get_rand_128() of the RP2040, and ascon_drbg_generate() copies from
+// a buffer that is refilled every ASCON_DRBG_BYTES
+#define DRBG_SAMPLES 100000
+#define NONCE_BYTES 16
+
+static int check_kat(void) {
+    ascon_drbg_t d, e;
+    unsigned char xof[2 * ASCON_DRBG_BYTES], out[2 * ASCON_DRBG_BYTES], out2[ASCON_DRBG_BYTES];
+
+    // The first refill is Ascon-XOF of the seed
+    ascon_xof(xof, ASCON_DRBG_BYTES, bench_key, sizeof(bench_key));
+    ascon_drbg_seed(&d, bench_key, sizeof(bench_key));
+    ascon_drbg_generate(&d, out, 20);
+    ascon_drbg_generate(&d, out + 20, ASCON_DRBG_BYTES - 20);
+    if (memcmp(out, xof, ASCON_DRBG_BYTES) != 0) return 0;
+
+    // After the refill the output is no longer the xof stream, but the same
+    // seed still gives the same output, and a reseed a different one
+    ascon_xof(xof, sizeof(xof), bench_key, sizeof(bench_key));
+    ascon_drbg_generate(&d, out + ASCON_DRBG_BYTES, ASCON_DRBG_BYTES);
+    if (memcmp(out + ASCON_DRBG_BYTES, xof + ASCON_DRBG_BYTES, ASCON_DRBG_BYTES) == 0) return 0;
+    ascon_drbg_seed(&e, bench_key, sizeof(bench_key));
+    ascon_drbg_generate(&e, out2, ASCON_DRBG_BYTES);
+    ascon_drbg_generate(&e, out2, ASCON_DRBG_BYTES);
+    if (memcmp(out + ASCON_DRBG_BYTES, out2, ASCON_DRBG_BYTES) != 0) return 0;
+    ascon_drbg_seed(&e, bench_key, sizeof(bench_key));
+    ascon_drbg_reseed(&e, bench_key32, sizeof(bench_key32));
+    ascon_drbg_generate(&e, out2, ASCON_DRBG_BYTES);
+    return memcmp(out, out2, ASCON_DRBG_BYTES) != 0 && d.refills == 2;
+}
+
+// 0: getrandom(), 1: ascon_drbg_generate(), 2: the same with the refills
+// moved out of the measured call
+static int next_nonce(ascon_drbg_t *d, unsigned char *nonce, int source) {
+    if (source) {
+        ascon_drbg_generate(d, nonce, NONCE_BYTES);
+        return 1;
+    }
+    return getrandom(nonce, NONCE_BYTES, 0) == NONCE_BYTES;
+}
+
+int main(void) {
+    if (!check_kat()) {
+        fprintf(stderr, "%s: known answer test failed\n", BACKEND_NAME);
+        return 1;
+    }
+
+    uint64_t *samples = malloc(sizeof(uint64_t) * DRBG_SAMPLES);
+    unsigned char nonce[NONCE_BYTES];
+    ascon_drbg_t d;
+    if (!samples) return 1;
+    uint64_t overhead = bench_timer_overhead_ns();
+    printf("# timer overhead: %llu ns\n", (unsigned long long)overhead);
+    ascon_drbg_seed(&d, bench_key, sizeof(bench_key));
+
+    bench_print_latency_header();
+    for (int source = 0; source < 3; source++) {
+        static const char *const ops[] = {"nonce", "nonce", "nonce_idle_refill"};
+        const char *impl = source ? BACKEND_NAME : "getrandom";
+
+        uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < DRBG_SAMPLES; i++) {
+            if (!next_nonce(&d, nonce, source)) return 1;
+        }
+        uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+        uint64_t ns = t1 - t0, cycles = c1 - c0;
+
+        for (int i = 0; i < DRBG_SAMPLES; i++) {
+            // As refill_encryption_pool() of the sensor, between two packets
+            if (source == 2 && ASCON_DRBG_BYTES - d.pos < NONCE_BYTES) ascon_drbg_refill(&d);
+            t0 = bench_now_ns();
+            if (!next_nonce(&d, nonce, source)) return 1;
+            t1 = bench_now_ns();
+            samples[i] = t1 - t0 > overhead ? t1 - t0 - overhead : 0;
+        }
+        bench_latency latency = bench_latency_summary(samples, DRBG_SAMPLES);
+        bench_print_latency_row(impl, ops[source], NONCE_BYTES, DRBG_SAMPLES, ns, cycles, &latency);
+    }
+
+    // The part that the sensor moves off the hot path
+    uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+    for (int i = 0; i < DRBG_SAMPLES; i++) {
+        ascon_drbg_refill(&d);
+    }
+    uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+    for (int i = 0; i < DRBG_SAMPLES; i++) {
+        uint64_t s0 = bench_now_ns();
+        ascon_drbg_refill(&d);
+        uint64_t s1 = bench_now_ns();
+        samples[i] = s1 - s0 > overhead ? s1 - s0 - overhead : 0;
+    }
+    bench_latency latency = bench_latency_summary(samples, DRBG_SAMPLES);
+    bench_print_latency_row(BACKEND_NAME, "refill", ASCON_DRBG_BYTES, DRBG_SAMPLES, t1 - t0, c1 - c0, &latency);
+
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "api.h"
+#include "ascon.h"
+#include "config.h"
+#include "bench.h"
+
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+#define VARIANT_NAME "ascon-aead128"
+#else
+#define VARIANT_NAME "ascon"
+#endif
+
+#if ASCON_BACKEND == ASCON_BACKEND_OPT64
+#define BACKEND_NAME VARIANT_NAME "-opt64"
+#elif ASCON_BACKEND == ASCON_BACKEND_BI32
+#define BACKEND_NAME VARIANT_NAME "-bi32"
+#else
+#define BACKEND_NAME VARIANT_NAME "-armv6m"
+#endif
+
+#define HAS_PRF (ASCON_VARIANT == ASCON_VARIANT_128A)
+
+// Input sizes of key/nonce derivation and short MACs
+static const size_t hash_sizes[] = {16, 64, 256};
+#define HASH_NUM_SIZES (sizeof(hash_sizes) / sizeof(hash_sizes[0]))
+
+// Output size of the xof rows, one derived key and nonce
+#define XOF_OUTBYTES 32
+
+// Known answers: key = 00..0F, input = 00..27 (40 bytes, one full and one
+// partial block of every rate), 40 output bytes for the xof and prf
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+// Ascon-XOF128 (SP 800-232)
+static const unsigned char kat_xof[40] = {
+    0xA6, 0x32, 0x89, 0x4E, 0xAB, 0x39, 0xF9, 0xD4, 0x8F, 0xA4, 0xC2, 0xE3,
+    0x9C, 0x24, 0x89, 0x96, 0x11, 0x8F, 0xA8, 0xDE, 0x6F, 0x21, 0x7E, 0x6D,
+    0x94, 0x54, 0x39, 0x50, 0xD7, 0x97, 0xC1, 0x09, 0x6E, 0x19, 0xE0, 0x45,
+    0xE4, 0x00, 0x14, 0x53
+};
+#else
+// Ascon-XOF v1.2
+static const unsigned char kat_xof[40] = {
+    0xDC, 0x16, 0x48, 0x4B, 0x8E, 0x84, 0xE7, 0x5B, 0x90, 0x11, 0x4B, 0x7F,
+    0xA6, 0x5B, 0x4F, 0x3B, 0x40, 0x62, 0xA0, 0xDF, 0x7C, 0x57, 0x4B, 0xDC,
+    0xA7, 0x5B, 0x48, 0x52, 0x04, 0xF0, 0x70, 0x27, 0x8D, 0x78, 0xDF, 0x6A,
+    0xC8, 0xAF, 0xA0, 0xC3
+};
+
+static const unsigned char kat_prf[40] = {
+    0x78, 0x8E, 0x43, 0x96, 0xE6, 0xF9, 0x04, 0xD7, 0x1D, 0xD9, 0x76, 0x38,
+    0x82, 0x17, 0xC8, 0x1B, 0x42, 0x4B, 0xDC, 0x50, 0x14, 0x1C, 0x7D, 0xDB,
+    0x9F, 0x86, 0x47, 0x16, 0x28, 0x36, 0x75, 0xD1, 0x4F, 0x98, 0x78, 0x48,
+    0xE7, 0x2C, 0xFB, 0x92
+};
+
+static const unsigned char kat_mac[16] = {
+    0x47, 0x6E, 0xAE, 0xC5, 0xAC, 0x60, 0x84, 0x97,
+    0x65, 0x01, 0x44, 0x6E, 0xAF, 0x61, 0x80, 0xB5
+};
+
+// Ascon-PrfShort over the first 12 input bytes
+static const unsigned char kat_prfs[16] = {
+    0x56, 0xAC, 0x39, 0x8C, 0x9A, 0x39, 0xDA, 0x69,
+    0x38, 0x0A, 0x9B, 0x14, 0x0F, 0x20, 0xFA, 0x51
+};
+#endif
+
+static int check_kat(void) {
+    unsigned char in[40], out[40];
+    for (int i = 0; i < 40; i++) in[i] = (unsigned char)i;
+    ascon_xof(out, 40, in, 40);
+    if (memcmp(out, kat_xof, 40) != 0) return 0;
+#if HAS_PRF
+    unsigned char k[16];
+    for (int i = 0; i < 16; i++) k[i] = (unsigned char)i;
+    ascon_prf(out, 40, in, 40, k);
+    if (memcmp(out, kat_prf, 40) != 0) return 0;
+    ascon_mac(out, in, 40, k);
+    if (memcmp(out, kat_mac, 16) != 0 || ascon_mac_verify(kat_mac, in, 40, k) != 0) return 0;
+    ascon_prfs(out, in, 12, k);
+    if (memcmp(out, kat_prfs, 16) != 0 || ascon_prfs_verify(kat_prfs, in, 12, k) != 0) return 0;
+    // Forged tags and oversized PrfShort inputs must be rejected
+    out[15] ^= 1;
+    if (ascon_mac_verify(out, in, 40, k) == 0 || ascon_prfs_verify(out, in, 12, k) == 0 ||
+        ascon_prfs(out, in, ASCON_PRFS_MAX_INBYTES + 1, k) == 0) {
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+int main(void) {
+    if (!check_kat()) {
+        fprintf(stderr, "%s: known answer test failed\n", BACKEND_NAME);
+        return 1;
+    }
+
+    size_t max_len = hash_sizes[HASH_NUM_SIZES - 1];
+    unsigned char *in = malloc(max_len);
+    unsigned char out[XOF_OUTBYTES];
+    if (!in) return 1;
+    for (size_t i = 0; i < max_len; i++) in[i] = (unsigned char)i;
+
+    bench_print_header();
+    for (size_t s = 0; s < HASH_NUM_SIZES; s++) {
+        size_t len = hash_sizes[s];
+        int iterations = bench_iterations(len);
+
+        uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            in[0] = (unsigned char)i;
+            ascon_xof(out, XOF_OUTBYTES, in, len);
+        }
+        uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "xof", len, iterations, t1 - t0, c1 - c0);
+
+#if HAS_PRF
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            in[0] = (unsigned char)i;
+            ascon_prf(out, 16, in, len, bench_key);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "prf", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            in[0] = (unsigned char)i;
+            ascon_mac(out, in, len, bench_key);
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "mac", len, iterations, t1 - t0, c1 - c0);
+
+        ascon_mac(out, in, len, bench_key);
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            if (ascon_mac_verify(out, in, len, bench_key) != 0) {
+                fprintf(stderr, "%s: mac verification failed\n", BACKEND_NAME);
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(BACKEND_NAME, "mac_verify", len, iterations, t1 - t0, c1 - c0);
+
+        // Ascon-PrfShort is limited to 16 input bytes
+        if (len <= ASCON_PRFS_MAX_INBYTES) {
+            t0 = bench_now_ns(), c0 = bench_cycles();
+            for (int i = 0; i < iterations; i++) {
+                in[0] = (unsigned char)i;
+                ascon_prfs(out, in, len, bench_key);
+            }
+            c1 = bench_cycles(), t1 = bench_now_ns();
+            bench_print_row(BACKEND_NAME, "prfs", len, iterations, t1 - t0, c1 - c0);
+        }
+#endif
+    }
+
+    free(in);
+    return 0;
+}
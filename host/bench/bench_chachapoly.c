@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "api.h"
+#include "chachapoly.h"
+#include "crypto_aead.h"
+#include "lwc_crypto_aead.h"
+#include "bench.h"
+
+#if defined(__OPTIMIZE_SIZE__)
+#define IMPL_NAME "chacha20-poly1305-Os"
+#else
+#define IMPL_NAME "chacha20-poly1305"
+#endif
+
+// RFC 8439 2.8.2: key = 80..9F, 114 byte message, first and last 16 bytes
+// of the ciphertext and the tag
+static const char kat_m[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one "
+                            "tip for the future, sunscreen would be it.";
+static const unsigned char kat_nonce[12] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41,
+                                            0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+static const unsigned char kat_ad[12] = {0x50, 0x51, 0x52, 0x53, 0xC0, 0xC1,
+                                         0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7};
+static const unsigned char kat_c_head[16] = {0xD3, 0x1A, 0x8D, 0x34, 0x64, 0x8E, 0x60, 0xDB,
+                                             0x7B, 0x86, 0xAF, 0xBC, 0x53, 0xEF, 0x7E, 0xC2};
+static const unsigned char kat_c_tail[16] = {0xDE, 0xF0, 0x8E, 0x4B, 0x7A, 0x9D, 0xE5, 0x76,
+                                             0xD2, 0x65, 0x86, 0xCE, 0xC6, 0x4B, 0x61, 0x16};
+static const unsigned char kat_tag[16] = {0x1A, 0xE1, 0x0B, 0x59, 0x4F, 0x09, 0xE2, 0x6A,
+                                          0x7E, 0x90, 0x2E, 0xCB, 0xD0, 0x60, 0x06, 0x91};
+
+static int check_kat(void) {
+    unsigned char k[32], c[sizeof(kat_m) - 1 + CRYPTO_ABYTES], p[sizeof(kat_m)];
+    size_t len = sizeof(kat_m) - 1;
+    unsigned long long clen, plen;
+    for (int i = 0; i < 32; i++) k[i] = (unsigned char)(0x80 + i);
+    crypto_aead_encrypt(c, &clen, (const unsigned char *)kat_m, len, kat_ad, 12, NULL, kat_nonce, k);
+    int ok = clen == len + 16 && memcmp(c, kat_c_head, 16) == 0 &&
+             memcmp(c + len - 16, kat_c_tail, 16) == 0 && memcmp(c + len, kat_tag, 16) == 0;
+    // The descriptor reaches the same functions, and a forged tag is rejected
+    ok = ok && lwc_aead_cipher.decrypt(p, &plen, NULL, c, clen, kat_ad, 12, kat_nonce, k) == 0 &&
+         plen == len && memcmp(p, kat_m, len) == 0;
+    c[clen - 1] ^= 1;
+    return ok && lwc_aead_cipher.decrypt(p, &plen, NULL, c, clen, kat_ad, 12, kat_nonce, k) != 0;
+}
+
+int main(void) {
+    if (lwc_aead_cipher.KeyBytes != 32 || lwc_aead_cipher.NonceBytes != 12 || !check_kat()) {
+        fprintf(stderr, "%s: known answer test failed\n", IMPL_NAME);
+        return 1;
+    }
+
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    unsigned long long ad_len = strlen(BENCH_AD);
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {0};
+    size_t max_len = bench_sizes[BENCH_NUM_SIZES - 1];
+    unsigned char *m = malloc(max_len);
+    unsigned char *c = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *p = malloc(max_len);
+    if (!m || !c || !p) return 1;
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+
+    // Reference frame, byte comparable with a sensor build using the same inputs
+    unsigned long long clen, mlen;
+    crypto_aead_encrypt(c, &clen, m, 2, ad, ad_len, NULL, nonce, bench_key32);
+    bench_print_hex("scenario 1 frame", c, (size_t)clen);
+
+    bench_print_header();
+    for (size_t s = 0; s < BENCH_NUM_SIZES; s++) {
+        size_t len = bench_sizes[s];
+        int iterations = bench_iterations(len);
+
+        uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            crypto_aead_encrypt(c, &clen, m, len, ad, ad_len, NULL, nonce, bench_key32);
+        }
+        uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "encrypt", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            if (crypto_aead_decrypt(p, &mlen, NULL, c, clen, ad, ad_len, nonce, bench_key32) != 0) {
+                fprintf(stderr, "%s: decryption failed\n", IMPL_NAME);
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "decrypt", len, iterations, t1 - t0, c1 - c0);
+    }
+
+    free(m);
+    free(c);
+    free(p);
+    return 0;
+}
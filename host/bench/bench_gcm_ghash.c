@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "api.h"
+#include "gcm.h"
+#include "bench.h"
+
+#if defined(MBEDTLS_AESNI_C)
+#define GHASH_NAME "-clmul"
+#elif defined(MBEDTLS_GCM_8BIT_TABLES)
+#define GHASH_NAME "-8bit"
+#else
+#define GHASH_NAME "-4bit"
+#endif
+
+#if defined(MBEDTLS_AES_FIXSLICED)
+#define AES_NAME "-fixsliced"
+#else
+#define AES_NAME ""
+#endif
+
+#if defined(MBEDTLS_GCM_FUSED)
+#define LOOP_NAME "-fused"
+#else
+#define LOOP_NAME ""
+#endif
+
+// Optimization level of the sensor-style builds
+#if defined(__OPTIMIZE_SIZE__)
+#define OPT_NAME "-Os"
+#elif !defined(__OPTIMIZE__)
+#define OPT_NAME "-O0"
+#else
+#define OPT_NAME ""
+#endif
+
+#if defined(MBEDTLS_GCM_AGGREGATE)
+#define IMPL_NAME "ghash-agg4" GHASH_NAME AES_NAME LOOP_NAME OPT_NAME
+#else
+#define IMPL_NAME "ghash" GHASH_NAME AES_NAME LOOP_NAME OPT_NAME
+#endif
+
+// One block, the aggregated path alone (4 blocks), a 256 byte export chunk
+// and the bulk transfer
+static const size_t sizes[] = {16, 64, 256, 2400};
+#define NUM_SIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+// Tags of bench_key, BENCH_AD, zero nonce and m[i] = i from the 4-bit table
+// path one block at a time, every GHASH variant must match them bit for bit
+static const unsigned char kat_tags[NUM_SIZES][16] = {
+    {0x77, 0x75, 0x49, 0xF0, 0x5B, 0xE1, 0x50, 0x68,
+     0x4C, 0xD8, 0x60, 0x3B, 0xC0, 0x38, 0x79, 0xD2},
+    {0xE5, 0x20, 0x0E, 0xFF, 0x50, 0x74, 0x63, 0x8B,
+     0x97, 0x11, 0x1E, 0x51, 0x8A, 0x73, 0x16, 0xC5},
+    {0xD0, 0xAD, 0xF6, 0x36, 0xE1, 0xEA, 0xC3, 0x7A,
+     0xB3, 0xC9, 0xA5, 0x88, 0x1D, 0xB5, 0x1B, 0xB4},
+    {0x0E, 0x40, 0xDC, 0x4B, 0x58, 0x8C, 0xB3, 0x29,
+     0xD0, 0x4B, 0x41, 0x02, 0xFF, 0x6F, 0x5D, 0xD4}
+};
+
+int main(void) {
+    nbedtls_gcm_aead_context key;
+    size_t max_len = sizes[NUM_SIZES - 1];
+    unsigned char *m = malloc(max_len);
+    unsigned char *c = malloc(max_len + CRYPTO_ABYTES);
+    unsigned char *p = malloc(max_len + CRYPTO_ABYTES);
+    if (!m || !c || !p) return 1;
+    for (size_t i = 0; i < max_len; i++) m[i] = (unsigned char)i;
+
+    const unsigned char *ad = (const unsigned char *)BENCH_AD;
+    size_t ad_len = strlen(BENCH_AD);
+    unsigned char nonce[CRYPTO_NPUBBYTES] = {0};
+    unsigned long long clen, mlen;
+    nbedtls_gcm_aead_setkey(&key, bench_key);
+
+    for (size_t s = 0; s < NUM_SIZES; s++) {
+        nbedtls_gcm_aead_seal(&key, c, &clen, m, sizes[s], ad, ad_len, nonce);
+        if (memcmp(c + sizes[s], kat_tags[s], 16) != 0 ||
+            nbedtls_gcm_aead_open(&key, p, &mlen, c, clen, ad, ad_len, nonce) != 0 ||
+            memcmp(p, m, sizes[s]) != 0) {
+            fprintf(stderr, "%s: known answer test failed\n", IMPL_NAME);
+            return 1;
+        }
+    }
+
+    // RAM of the keyed context, mostly the GHASH tables
+    printf("# %s: context %zu bytes\n", IMPL_NAME, sizeof(nbedtls_gcm_aead_context));
+    bench_print_header();
+    for (size_t s = 0; s < NUM_SIZES; s++) {
+        size_t len = sizes[s];
+        int iterations = bench_iterations(len);
+
+        uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            nonce[0] = (unsigned char)i;
+            nbedtls_gcm_aead_seal(&key, c, &clen, m, len, ad, ad_len, nonce);
+        }
+        uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "encrypt_keyed", len, iterations, t1 - t0, c1 - c0);
+
+        t0 = bench_now_ns(), c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            if (nbedtls_gcm_aead_open(&key, p, &mlen, c, clen, ad, ad_len, nonce) != 0) {
+                fprintf(stderr, "%s: decryption failed\n", IMPL_NAME);
+                return 1;
+            }
+        }
+        c1 = bench_cycles(), t1 = bench_now_ns();
+        bench_print_row(IMPL_NAME, "decrypt_keyed", len, iterations, t1 - t0, c1 - c0);
+    }
+
+    nbedtls_gcm_aead_free(&key);
+    free(m);
+    free(c);
+    free(p);
+    return 0;
+}
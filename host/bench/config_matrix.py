@@ -0,0 +1,113 @@
+"""Collects the Ascon configuration matrix built by the ascon_config_matrix target.
+
+Every line of the config file names one build of the AEAD (inlining,
+unrolling and optimization level) with its benchmark and size executables.
+For every build the text size of the AEAD is the text size of its size
+executable minus the baseline, and the encrypt/decrypt TSC ticks come from the
+bench_ascon rows of every scenario payload size. Every benchmark runs --runs
+times, one build after the other, and the fastest run is kept. Writes all
+results and the Pareto front (text size against encrypt + decrypt ticks) per
+payload size.
+"""
+import argparse
+import csv
+import io
+import os
+import subprocess
+import sys
+
+FIELDS = ["config", "inline_mode", "inline_perm", "unroll_loops", "opt",
+          "text_bytes", "bytes", "encrypt_tsc", "decrypt_tsc"]
+
+
+def text_size(size_tool: str, path: str) -> int:
+    out = subprocess.run([size_tool, path], check=True, capture_output=True, text=True).stdout
+    # Berkeley format: header line, then text data bss dec hex filename
+    return int(out.splitlines()[1].split()[0])
+
+
+def bench_cycles(path: str, cycles: dict = None) -> dict:
+    """Returns {bytes: {op: TSC ticks per call}} of the encrypt and decrypt rows.
+
+    With cycles, the result of an earlier run, keeps the minimum of both runs.
+    """
+    out = subprocess.run([path], check=True, capture_output=True, text=True).stdout
+    rows = [line for line in out.splitlines() if line and not line.startswith("#")]
+    cycles = {} if cycles is None else cycles
+    for row in csv.DictReader(io.StringIO("\n".join(rows))):
+        if row["op"] in ("encrypt", "decrypt"):
+            n = int(row["bytes"])
+            ticks = float(row["tsc_per_byte"]) * n
+            ops = cycles.setdefault(n, {})
+            ops[row["op"]] = min(ops.get(row["op"], ticks), ticks)
+    return cycles
+
+
+def pareto(results: list) -> list:
+    """Keeps the rows no other row beats in both text size and ticks."""
+    front = []
+    for r in results:
+        cost = r["encrypt_tsc"] + r["decrypt_tsc"]
+        dominated = any(
+            o["text_bytes"] <= r["text_bytes"] and o["encrypt_tsc"] + o["decrypt_tsc"] <= cost
+            and (o["text_bytes"] < r["text_bytes"] or o["encrypt_tsc"] + o["decrypt_tsc"] < cost)
+            for o in results)
+        if not dominated:
+            front.append(r)
+    return sorted(front, key=lambda r: r["text_bytes"])
+
+
+def write_csv(path: str, rows: list):
+    with open(path, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=FIELDS)
+        writer.writeheader()
+        for r in rows:
+            writer.writerow({**r, "encrypt_tsc": f"{r['encrypt_tsc']:.0f}",
+                             "decrypt_tsc": f"{r['decrypt_tsc']:.0f}"})
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("configs", help="config file written by CMake")
+    parser.add_argument("--size-tool", default="size")
+    parser.add_argument("--baseline", required=True, help="size executable without the AEAD")
+    parser.add_argument("--out-dir", required=True)
+    parser.add_argument("--runs", type=int, default=15,
+                        help="benchmark runs per build, the fastest is kept")
+    args = parser.parse_args()
+
+    baseline = text_size(args.size_tool, args.baseline)
+    with open(args.configs) as f:
+        configs = [line.split() for line in f if line.strip()]
+    # One run of every build per round, so a slow phase of the host does not
+    # hit all runs of one build
+    cycles = [None] * len(configs)
+    for run in range(args.runs):
+        print(f"run {run + 1}/{args.runs}", file=sys.stderr)
+        for i, config in enumerate(configs):
+            cycles[i] = bench_cycles(config[5], cycles[i])
+
+    results = []
+    for (name, mode, perm, unroll, opt, bench, size_exe), config_cycles in zip(configs, cycles):
+        text = text_size(args.size_tool, size_exe) - baseline
+        print(f"{name}: {text} bytes", file=sys.stderr)
+        for n, ops in sorted(config_cycles.items()):
+            results.append({"config": name, "inline_mode": mode, "inline_perm": perm,
+                            "unroll_loops": unroll, "opt": opt, "text_bytes": text, "bytes": n,
+                            "encrypt_tsc": ops["encrypt"], "decrypt_tsc": ops["decrypt"]})
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    write_csv(os.path.join(args.out_dir, "ascon_config_matrix.csv"), results)
+    front = []
+    for n in sorted({r["bytes"] for r in results}):
+        front += pareto([r for r in results if r["bytes"] == n])
+    write_csv(os.path.join(args.out_dir, "ascon_config_pareto.csv"), front)
+
+    print(",".join(FIELDS))
+    for r in front:
+        print(f"{r['config']},{r['inline_mode']},{r['inline_perm']},{r['unroll_loops']},{r['opt']},"
+              f"{r['text_bytes']},{r['bytes']},{r['encrypt_tsc']:.0f},{r['decrypt_tsc']:.0f}")
+
+
+if __name__ == "__main__":
+    main()
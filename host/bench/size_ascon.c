@@ -0,0 +1,22 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ascon.h"
+
+// Smallest program that seals and opens one frame with the keyed context,
+// like encrypt()/decrypt() on the sensor. Built with and without
+// SIZE_BASELINE, the difference of the text sizes is the code the AEAD adds.
+int main(int argc, char **argv) {
+    unsigned char buf[64] = {0};
+    uint64_t len = (uint64_t)argc;
+    (void)argv;
+#ifndef SIZE_BASELINE
+    ascon_aead_keyctx_t key;
+    uint64_t clen;
+    ascon_aead_setkey(&key, buf);
+    ascon_aead_seal(&key, buf + 16, &clen, buf, len, buf, len, buf);
+    if (ascon_aead_open(&key, buf, &len, buf + 16, clen, buf, len, buf) != 0) return 1;
+#endif
+    printf("%u\n", buf[(size_t)len % sizeof(buf)]);
+    return 0;
+}
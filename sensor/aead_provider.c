@@ -0,0 +1,166 @@
+#include <string.h>
+#include "aead_provider.h"
+
+#if AEAD_HAVE_ASCON_MASKED
+#include "masked_ascon_encryption.h"
+#endif
+#if ASCON_LIB_MODE
+#include "ascon.h"
+#endif
+#if AEAD_HAVE_AES_GCM
+#include "gcm.h"
+#endif
+#if AEAD_HAVE_CHACHA20_POLY1305
+#include "chachapoly.h"
+#endif
+
+
+#if AEAD_HAVE_ASCON_MASKED
+// The masked key lives in masked_ascon_encryption.c
+static void masked_setkey(void *ctx, const uint8_t *key) {
+    (void)ctx;
+    init_prng();
+    initialize_masked_key(key);
+}
+
+static int masked_seal(void *ctx, uint8_t *c, size_t *clen, const uint8_t *m, size_t mlen,
+                       const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    (void)ctx;
+    masked_ascon128a_encrypt(c, clen, m, mlen, ad, adlen, npub);
+    return 0;
+}
+
+static int masked_open(void *ctx, uint8_t *m, size_t *mlen, const uint8_t *c, size_t clen,
+                       const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    (void)ctx;
+    return masked_ascon128a_decrypt(m, mlen, c, clen, ad, adlen, npub) >= 0 ? 0 : -1;
+}
+#endif
+
+
+#if ASCON_LIB_MODE
+static ascon_aead_keyctx_t ascon_key;  // Key in the permutation word format
+
+static void ascon_lib_setkey(void *ctx, const uint8_t *key) {
+    ascon_aead_setkey((ascon_aead_keyctx_t *)ctx, key);
+}
+
+static int ascon_lib_seal(void *ctx, uint8_t *c, size_t *clen, const uint8_t *m, size_t mlen,
+                          const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    uint64_t len = 0;
+    int ret = ascon_aead_seal((const ascon_aead_keyctx_t *)ctx, c, &len, m, mlen, ad, adlen, npub);
+    *clen = (size_t)len;
+    return ret;
+}
+
+static int ascon_lib_open(void *ctx, uint8_t *m, size_t *mlen, const uint8_t *c, size_t clen,
+                          const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    uint64_t len = 0;
+    int ret = ascon_aead_open((const ascon_aead_keyctx_t *)ctx, m, &len, c, clen, ad, adlen, npub);
+    *mlen = (size_t)len;
+    return ret;
+}
+#endif
+
+
+#if AEAD_HAVE_AES_GCM
+static nbedtls_gcm_aead_context gcm_key;  // AES round keys and GHASH tables
+
+static void gcm_setkey(void *ctx, const uint8_t *key) {
+    nbedtls_gcm_aead_setkey((nbedtls_gcm_aead_context *)ctx, key);
+}
+
+static int gcm_seal(void *ctx, uint8_t *c, size_t *clen, const uint8_t *m, size_t mlen,
+                    const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    unsigned long long len = 0;
+    int ret = nbedtls_gcm_aead_seal((nbedtls_gcm_aead_context *)ctx, c, &len, m, mlen, ad, adlen, npub);
+    *clen = (size_t)len;
+    return ret;
+}
+
+static int gcm_open(void *ctx, uint8_t *m, size_t *mlen, const uint8_t *c, size_t clen,
+                    const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    unsigned long long len = 0;
+    int ret = nbedtls_gcm_aead_open((nbedtls_gcm_aead_context *)ctx, m, &len, c, clen, ad, adlen, npub);
+    *mlen = (size_t)len;
+    return ret;
+}
+#endif
+
+
+#if AEAD_HAVE_CHACHA20_POLY1305
+static uint8_t chachapoly_key[CHACHAPOLY_KEYBYTES];  // ChaCha20 has no key schedule
+
+static void chachapoly_setkey(void *ctx, const uint8_t *key) {
+    memcpy(ctx, key, CHACHAPOLY_KEYBYTES);
+}
+
+static int chachapoly_seal_frame(void *ctx, uint8_t *c, size_t *clen, const uint8_t *m, size_t mlen,
+                                 const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    chachapoly_seal(c, m, mlen, ad, adlen, npub, (const uint8_t *)ctx);
+    *clen = mlen + CHACHAPOLY_TAGBYTES;
+    return 0;
+}
+
+static int chachapoly_open_frame(void *ctx, uint8_t *m, size_t *mlen, const uint8_t *c, size_t clen,
+                                 const uint8_t *ad, size_t adlen, const uint8_t *npub) {
+    int ret = chachapoly_open(m, c, clen, ad, adlen, npub, (const uint8_t *)ctx);
+    *mlen = ret == 0 ? clen - CHACHAPOLY_TAGBYTES : 0;
+    return ret;
+}
+#endif
+
+
+static const aead_provider aead_providers[] = {
+#if AEAD_HAVE_ASCON_MASKED
+    {"ascon-128a", "masked", 16, 16, 16, ENCRYPTION_ASCON_MASKED,
+     NULL, masked_setkey, masked_seal, masked_open},
+#endif
+#if AEAD_HAVE_ASCON_UNMASKED
+    {"ascon-128a", "armv6m", 16, 16, 16, ENCRYPTION_ASCON_UNMASKED,
+     &ascon_key, ascon_lib_setkey, ascon_lib_seal, ascon_lib_open},
+#endif
+#if AEAD_HAVE_AES_GCM
+    {"aes-gcm", "mbedtls-fewer", 16, 12, 16, ENCRYPTION_AES_GCM,
+     &gcm_key, gcm_setkey, gcm_seal, gcm_open},
+#endif
+#if AEAD_HAVE_NONE
+    {"none", "plaintext", 0, 0, 0, ENCRYPTION_NONE,
+     NULL, NULL, NULL, NULL},
+#endif
+#if AEAD_HAVE_ASCON_AEAD128
+    {"ascon-aead128", "armv6m", 16, 16, 16, ENCRYPTION_ASCON_AEAD128,
+     &ascon_key, ascon_lib_setkey, ascon_lib_seal, ascon_lib_open},
+#endif
+#if AEAD_HAVE_ASCON_AUTH
+    // Ascon-PrfShort/Ascon-Mac over the values and the sequence number, no nonce
+    {"ascon-mac", "armv6m", 16, 0, 16, ENCRYPTION_ASCON_AUTH,
+     NULL, NULL, NULL, NULL},
+#endif
+#if AEAD_HAVE_CHACHA20_POLY1305
+    {"chacha20-poly1305", "chachapoly-ref", CHACHAPOLY_KEYBYTES, CHACHAPOLY_NONCEBYTES, CHACHAPOLY_TAGBYTES,
+     ENCRYPTION_CHACHA20_POLY1305, chachapoly_key, chachapoly_setkey, chachapoly_seal_frame, chachapoly_open_frame},
+#endif
+};
+
+#define AEAD_PROVIDER_COUNT (sizeof(aead_providers) / sizeof(aead_providers[0]))
+
+
+size_t aead_provider_count(void) {
+    return AEAD_PROVIDER_COUNT;
+}
+
+
+const aead_provider *aead_provider_at(size_t index) {
+    return index < AEAD_PROVIDER_COUNT ? &aead_providers[index] : NULL;
+}
+
+
+const aead_provider *aead_provider_find(uint8_t id) {
+    for (size_t i = 0; i < AEAD_PROVIDER_COUNT; i++) {
+        if (aead_providers[i].id == id) {
+            return &aead_providers[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,101 @@
+#ifndef AEAD_PROVIDER_H
+#define AEAD_PROVIDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Encryption modes, SELECTED_ENCRYPTION_MODE of the build and the provider id
+// in front of a frame when the image holds more than one provider
+#define ENCRYPTION_ASCON_MASKED   1
+#define ENCRYPTION_ASCON_UNMASKED 2
+#define ENCRYPTION_AES_GCM        3
+#define ENCRYPTION_NONE           4
+#define ENCRYPTION_ASCON_AEAD128  5
+#define ENCRYPTION_ASCON_AUTH     6
+#define ENCRYPTION_CHACHA20_POLY1305 7
+
+#if !defined(SELECTED_ENCRYPTION_MODE)
+#define SELECTED_ENCRYPTION_MODE ENCRYPTION_AES_GCM
+#endif
+
+// Providers built into the image (AEAD_PROVIDERS in CMakeLists.txt), by
+// default only SELECTED_ENCRYPTION_MODE
+#ifndef AEAD_HAVE_ASCON_MASKED
+#define AEAD_HAVE_ASCON_MASKED (SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_MASKED)
+#endif
+#ifndef AEAD_HAVE_ASCON_UNMASKED
+#define AEAD_HAVE_ASCON_UNMASKED (SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_UNMASKED)
+#endif
+#ifndef AEAD_HAVE_AES_GCM
+#define AEAD_HAVE_AES_GCM (SELECTED_ENCRYPTION_MODE == ENCRYPTION_AES_GCM)
+#endif
+#ifndef AEAD_HAVE_NONE
+#define AEAD_HAVE_NONE (SELECTED_ENCRYPTION_MODE == ENCRYPTION_NONE)
+#endif
+#ifndef AEAD_HAVE_ASCON_AEAD128
+#define AEAD_HAVE_ASCON_AEAD128 (SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_AEAD128)
+#endif
+#ifndef AEAD_HAVE_ASCON_AUTH
+#define AEAD_HAVE_ASCON_AUTH (SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_AUTH)
+#endif
+#ifndef AEAD_HAVE_CHACHA20_POLY1305
+#define AEAD_HAVE_CHACHA20_POLY1305 (SELECTED_ENCRYPTION_MODE == ENCRYPTION_CHACHA20_POLY1305)
+#endif
+
+#if AEAD_HAVE_ASCON_UNMASKED && AEAD_HAVE_ASCON_AEAD128
+#error "ASCON_UNMASKED and ASCON_AEAD128 build the same Ascon library, select one of them"
+#endif
+
+// The Ascon library of libs/ascon/armv6m (Ascon-128a or Ascon-AEAD128)
+#define ASCON_LIB_MODE (AEAD_HAVE_ASCON_UNMASKED || AEAD_HAVE_ASCON_AEAD128)
+#define ASCON_LIB_ID (AEAD_HAVE_ASCON_AEAD128 ? ENCRYPTION_ASCON_AEAD128 : ENCRYPTION_ASCON_UNMASKED)
+
+// 1 if frames start with the id of their provider, set by CMakeLists.txt when
+// AEAD_PROVIDERS holds more than one mode
+#ifndef AEAD_FRAME_ID
+#define AEAD_FRAME_ID 0
+#endif
+
+// Largest nonce field of a frame: the 16 byte Ascon nonce, and the type byte
+// of an Ascon session frame
+#define AEAD_MAX_NONCE_FIELD 17
+
+/**
+ * One encryption mode of the image. The first fields are those of aead_ctx
+ * (lwc_crypto_aead.h), the rest are the keyed context that encrypt() and
+ * decrypt() dispatch through.
+ */
+typedef struct aead_provider {
+    const char *variant_name;
+    const char *impl_name;
+    int KeyBytes;    // 0 without encryption
+    int NonceBytes;  // Nonce field of a frame, 0 if freshness comes from the AD
+    int ABytes;      // Tag
+
+    uint8_t id;      // ENCRYPTION_*
+    void *ctx;       // Key context of setkey, seal and open
+    // Expands the key into ctx, NULL if there is nothing to expand
+    void (*setkey)(void *ctx, const uint8_t *key);
+    // c = ciphertext || tag, NULL for NONE and ASCON_AUTH (see encrypt())
+    int (*seal)(void *ctx, uint8_t *c, size_t *clen,
+                const uint8_t *m, size_t mlen,
+                const uint8_t *ad, size_t adlen,
+                const uint8_t *npub);
+    // 0 if the tag matches. m is undefined otherwise, the Ascon providers
+    // write the plaintext before they check the tag
+    int (*open)(void *ctx, uint8_t *m, size_t *mlen,
+                const uint8_t *c, size_t clen,
+                const uint8_t *ad, size_t adlen,
+                const uint8_t *npub);
+} aead_provider;
+
+// Number of providers built into the image, ordered by id
+size_t aead_provider_count(void);
+
+// Provider at index (0 to aead_provider_count() - 1)
+const aead_provider *aead_provider_at(size_t index);
+
+// Provider with the given id, NULL if it is not built into the image
+const aead_provider *aead_provider_find(uint8_t id);
+
+#endif // AEAD_PROVIDER_H
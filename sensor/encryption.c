@@ -5,29 +5,13 @@
 #include "server_common.h"
 #include "pico/time.h"
 #include "pico/rand.h"
+#include "aead_provider.h"
 
-
-#define ENCRYPTION_ASCON_MASKED   1
-#define ENCRYPTION_ASCON_UNMASKED 2
-#define ENCRYPTION_AES_GCM        3
-#define ENCRYPTION_NONE           4
-
-
-#if !defined(SELECTED_ENCRYPTION_MODE)
-#define SELECTED_ENCRYPTION_MODE ENCRYPTION_AES_GCM
+#if ASCON_LIB_MODE || AEAD_HAVE_ASCON_AUTH || NONCE_DRBG
+#include "ascon.h"
 #endif
-
-#if SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_MASKED
-#define NONCE_SIZE 16
-#include "masked_ascon_encryption.h"
-#elif SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_UNMASKED
-#include "crypto_aead.h"
-#define NONCE_SIZE 16
-#elif SELECTED_ENCRYPTION_MODE == ENCRYPTION_AES_GCM
-#include "crypto_aead.h"
-#define NONCE_SIZE 12
-#else
-#define NONCE_SIZE 0
+#if AEAD_HAVE_AES_GCM
+#include "gcm.h"
 #endif
 
 #define TAG_SIZE 16
@@ -39,14 +23,197 @@ static unsigned char key_128[16] = {
     0x7C, 0xAC, 0xD4, 0xD8, 0x02, 0x3F, 0x0D, 0x88 
 };
 
+#if AEAD_HAVE_CHACHA20_POLY1305
+// ChaCha20 has no 128-bit key variant, key_128 followed by 16 more bytes
+static const unsigned char key_256[32] = {
+    0x9E, 0x88, 0xCD, 0xDB, 0x2D, 0xA9, 0x09, 0x93,
+    0x7C, 0xAC, 0xD4, 0xD8, 0x02, 0x3F, 0x0D, 0x88,
+    0x5B, 0x1F, 0x2C, 0x7A, 0x91, 0xE4, 0x3D, 0x06,
+    0xB8, 0x6A, 0xF2, 0x47, 0x0C, 0xD9, 0x83, 0x15
+};
+#endif
+
+// Provider of encrypt(), switched by select_next_encryption_mode()
+static const aead_provider *active_provider;
+
+#if ASCON_LIB_MODE
+static const ascon_aead_keyctx_t *ascon_key;  // Context of the Ascon provider
+
+// Pool of states that already ran the key/nonce initialization (P12), so
+// encrypt() only absorbs AD and plaintext and finalizes. 0 (default) disables
+// the pool.
+#ifndef ASCON_INIT_POOL_DEPTH
+#define ASCON_INIT_POOL_DEPTH 0
+#endif
+
+// Session mode chains the Ascon state across packets instead (see below)
+#ifndef ASCON_SESSION
+#define ASCON_SESSION 0
+#endif
+
+#define ASCON_USE_INIT_POOL (ASCON_INIT_POOL_DEPTH > 0 && !ASCON_SESSION)
+
+#if ASCON_USE_INIT_POOL
+typedef struct {
+    ascon_state_t state;
+    uint8_t nonce[CRYPTO_NPUBBYTES];
+} ascon_init_entry;
+
+static ascon_init_entry ascon_init_pool[ASCON_INIT_POOL_DEPTH];
+static int ascon_init_pool_count = 0;
+#endif
+
+#if ASCON_SESSION
+// One session per direction. A frame carries a type byte in front of the AD:
+// 'R' starts a new session from the nonce in front of it (resync/rekey),
+// 'S' continues the current session and carries no nonce.
+#ifndef ASCON_SESSION_RESYNC
+#define ASCON_SESSION_RESYNC 25  // Packets between resyncs, 0 only resyncs when needed
+#endif
+#define SESSION_FRAME_RESYNC 'R'
+#define SESSION_FRAME_CHAINED 'S'
+
+static ascon_session_t tx_session, rx_session;
+static int tx_session_valid = 0, rx_session_valid = 0;
+#endif
+#endif
+
+#if AEAD_HAVE_AES_GCM
+// Context of the AES-GCM provider, AES round keys and GHASH tables of key_128
+static nbedtls_gcm_aead_context *gcm_key;
+
+// Nonce, E(K, J0) and CTR keystream of the next packet, computed while idle
+// for payload_multiple readings, so encrypt() only XORs and runs GHASH.
+// Off unless GCM_PRECOMPUTE is 1.
+#ifndef GCM_PRECOMPUTE
+#define GCM_PRECOMPUTE 0
+#endif
+
+#if GCM_PRECOMPUTE
+static nbedtls_gcm_aead_precomp gcm_precomp;
+static int gcm_precomp_ready = 0;
+#endif
+#endif
+
+static size_t nonce_field_size = 0;
+
+// Nonce fields of this scenario, for the overhead in print_all_results()
+static uint32_t frames_sealed = 0;
+static uint32_t nonce_field_bytes = 0;
+
+// Nonces come from an Ascon-XOF DRBG instead of a get_rand_128() per packet.
+// It is seeded from get_rand_128() in init_primitives() and reseeded every
+// NONCE_DRBG_RESEED refills, refill_encryption_pool() refills its buffer
+// while idle, so a nonce is a copy out of the buffer.
+#ifndef NONCE_DRBG
+#define NONCE_DRBG 0
+#endif
+
+#if NONCE_DRBG
+#ifndef NONCE_DRBG_RESEED
+#define NONCE_DRBG_RESEED 64
+#endif
+
+static ascon_drbg_t nonce_drbg;
+
+static void nonce_drbg_seed(int reseed) {
+    rng_128_t rand128;
+    get_rand_128(&rand128);
+    if (reseed) {
+        ascon_drbg_reseed(&nonce_drbg, (const uint8_t *)&rand128, sizeof(rand128));
+    } else {
+        ascon_drbg_seed(&nonce_drbg, (const uint8_t *)&rand128, sizeof(rand128));
+    }
+    memset(&rand128, 0, sizeof(rand128));
+    ascon_drbg_refill(&nonce_drbg);
+}
+#endif
+
+// Latency of generate_nonce() in this scenario, for print_all_results()
+static uint32_t nonce_latency[NONCE_LATENCY_BUCKETS];
+
+// Implicit nonces: instead of the nonce, a frame carries a type byte in front
+// of the AD, and the nonce is the salt of the sensor XOR the direction and the
+// sequence number of the AD. 'K' frames carry the salt in front of the type
+// byte, the sensor sends them until a reply shows that the data storage has
+// it, and 'I' frames after that. A new salt is drawn whenever a sequence
+// number can come again (new scenario or provider, retry of a failed
+// notification), so a nonce is never used twice.
+#ifndef IMPLICIT_NONCE
+#define IMPLICIT_NONCE 0
+#endif
+
+#if IMPLICIT_NONCE
+#if ASCON_LIB_MODE && ASCON_SESSION
+#error "IMPLICIT_NONCE and ASCON_SESSION both replace the nonce field, select one of them"
+#endif
+
+#define IMPLICIT_FRAME_SALT 'K'
+#define IMPLICIT_FRAME_SEQ 'I'
+#define IMPLICIT_UPLINK 0x00    // Frames of the sensor
+#define IMPLICIT_DOWNLINK 0x80  // Replies of the data storage
+#define IMPLICIT_SALT_BYTES 16  // Largest nonce, providers use the first NonceBytes
+
+static uint8_t implicit_salt[IMPLICIT_SALT_BYTES];
+static int implicit_salt_acked = 0;
+static uint16_t implicit_last_seq = 0;
+static uint16_t implicit_next_seq = 0;  // Sequence number the pool and precomputation prepare
+
+static void implicit_nonce(uint8_t *nonce, size_t len, uint16_t seq_num, uint8_t direction) {
+    memcpy(nonce, implicit_salt, len);
+    nonce[0] ^= direction;
+    nonce[len - 2] ^= (uint8_t)(seq_num >> 8);
+    nonce[len - 1] ^= (uint8_t)seq_num;
+}
+
+static size_t implicit_nonce_field(uint8_t *field, const aead_provider *provider) {
+    size_t len = 0;
+    if (!implicit_salt_acked) {
+        memcpy(field, implicit_salt, provider->NonceBytes);
+        len = provider->NonceBytes;
+        field[len++] = IMPLICIT_FRAME_SALT;
+    } else {
+        field[len++] = IMPLICIT_FRAME_SEQ;
+    }
+    return len;
+}
+#endif
 
-uint8_t nonce[NONCE_SIZE];
 
 void init_primitives() {
-    #if SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_MASKED
-        init_prng();
-        initialize_masked_key(key_128);
+    // Time since boot, End is when the first encrypt() can run (the AES
+    // tables are generated here unless they are in ROM). Every provider of
+    // the image is keyed.
+    key_setup_time.start_time = (uint64_t)time_us_64();
+    #if NONCE_DRBG
+        nonce_drbg_seed(0);
+    #endif
+    for (size_t i = 0; i < aead_provider_count(); i++) {
+        const aead_provider *provider = aead_provider_at(i);
+        if (provider->setkey) {
+            #if AEAD_HAVE_CHACHA20_POLY1305
+            if (provider->KeyBytes == sizeof(key_256)) {
+                provider->setkey(provider->ctx, key_256);
+                continue;
+            }
+            #endif
+            provider->setkey(provider->ctx, key_128);
+        }
+    }
+    #if IMPLICIT_NONCE
+        generate_nonce(implicit_salt, sizeof(implicit_salt));
+    #endif
+    // The lowest id, so that select_next_encryption_mode() visits every
+    // provider before it wraps (SELECTED_ENCRYPTION_MODE of a single-mode build)
+    active_provider = aead_provider_at(0);
+    #if ASCON_LIB_MODE
+        ascon_key = aead_provider_find(ASCON_LIB_ID)->ctx;
     #endif
+    #if AEAD_HAVE_AES_GCM
+        gcm_key = aead_provider_find(ENCRYPTION_AES_GCM)->ctx;
+    #endif
+    refill_encryption_pool();
+    key_setup_time.end_time = (uint64_t)time_us_64();
     }
     
 
@@ -77,13 +244,268 @@ void log_end_encryption_time(uint16_t seq_num) {
 }
 
 
-void generate_nonce(uint8_t *nonce) {
+void generate_nonce(uint8_t *nonce, size_t len) {
+    if (len == 0) return;
+
+    uint64_t start = time_us_64();
+    #if NONCE_DRBG
+    ascon_drbg_generate(&nonce_drbg, nonce, len);
+    #else
     rng_128_t rand128;
     get_rand_128(&rand128);
-    memcpy(nonce, &rand128, NONCE_SIZE);
+    memcpy(nonce, &rand128, len);
+    #endif
+    uint64_t us = time_us_64() - start;
+
+    // Bucket 0 is below 1 us, bucket b from 2^(b-1) us, the last one collects the rest
+    int bucket = 0;
+    while (us > 0 && bucket < NONCE_LATENCY_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    nonce_latency[bucket]++;
+}
+
+
+const char *get_nonce_source() {
+    #if NONCE_DRBG
+    return "Ascon DRBG";
+    #else
+    return "get_rand_128";
+    #endif
 }
 
 
+void get_nonce_latency(uint32_t *counts) {
+    memcpy(counts, nonce_latency, sizeof(nonce_latency));
+}
+
+
+void refill_encryption_pool() {
+    #if NONCE_DRBG
+        // Less than the largest nonce left, so the next generate_nonce() does
+        // not run the permutation
+        if (ASCON_DRBG_BYTES - nonce_drbg.pos < 16) {
+            if (nonce_drbg.refills >= NONCE_DRBG_RESEED) {
+                nonce_drbg_seed(1);
+            } else {
+                ascon_drbg_refill(&nonce_drbg);
+            }
+        }
+    #endif
+    // Only for the active provider, the others would take idle time away
+    // from its measurements
+    #if ASCON_LIB_MODE && ASCON_USE_INIT_POOL && IMPLICIT_NONCE
+        // The nonces of the next sequence numbers, the next one on top
+        if (active_provider->id == ASCON_LIB_ID && ascon_init_pool_count == 0) {
+            for (int i = ASCON_INIT_POOL_DEPTH - 1; i >= 0; i--) {
+                ascon_init_entry *entry = &ascon_init_pool[ascon_init_pool_count++];
+                implicit_nonce(entry->nonce, sizeof(entry->nonce), (uint16_t)(implicit_next_seq + i), IMPLICIT_UPLINK);
+                ascon_aead_preinit(ascon_key, &entry->state, entry->nonce);
+            }
+        }
+    #elif ASCON_LIB_MODE && ASCON_USE_INIT_POOL
+        while (active_provider->id == ASCON_LIB_ID && ascon_init_pool_count < ASCON_INIT_POOL_DEPTH) {
+            ascon_init_entry *entry = &ascon_init_pool[ascon_init_pool_count];
+            generate_nonce(entry->nonce, sizeof(entry->nonce));
+            ascon_aead_preinit(ascon_key, &entry->state, entry->nonce);
+            ascon_init_pool_count++;
+        }
+    #endif
+    #if AEAD_HAVE_AES_GCM && GCM_PRECOMPUTE
+        size_t len = sizeof(uint16_t) * payload_multiple;
+        // Again after a scenario change, the unused nonce is dropped
+        uint8_t next_nonce[sizeof(gcm_precomp.npub)];
+        #if IMPLICIT_NONCE
+        implicit_nonce(next_nonce, sizeof(next_nonce), implicit_next_seq, IMPLICIT_UPLINK);
+        if (gcm_precomp_ready && memcmp(gcm_precomp.npub, next_nonce, sizeof(next_nonce)) != 0) {
+            gcm_precomp_ready = 0;  // Prepared for another salt or sequence number
+        }
+        #endif
+        if (active_provider->id == ENCRYPTION_AES_GCM && (!gcm_precomp_ready || gcm_precomp.len != len) &&
+            len <= MBEDTLS_GCM_AEAD_PRECOMP_BYTES) {
+            #if !IMPLICIT_NONCE
+            generate_nonce(next_nonce, sizeof(next_nonce));
+            #endif
+            gcm_precomp_ready = nbedtls_gcm_aead_precompute(gcm_key, &gcm_precomp, next_nonce, len) == 0;
+        }
+    #endif
+}
+
+
+int get_nonce_size() {
+    // Bytes written to the nonce field by the last encrypt()
+    return (int)nonce_field_size;
+}
+
+
+int get_max_nonce_size() {
+    // Largest nonce field encrypt() writes with the active provider
+    #if ASCON_LIB_MODE && ASCON_SESSION
+    if (active_provider->id == ASCON_LIB_ID) {
+        return active_provider->NonceBytes + 1;
+    }
+    #endif
+    #if IMPLICIT_NONCE
+    if (active_provider->NonceBytes > 0) {
+        return active_provider->NonceBytes + 1;  // Salt and type byte
+    }
+    #endif
+    return active_provider->NonceBytes;
+}
+
+
+int get_encryption_mode() {
+    return active_provider->id;
+}
+
+
+int select_next_encryption_mode() {
+    // Providers in the order of aead_provider.c, 0 when it wraps to the first
+    size_t i = 0;
+    while (aead_provider_at(i) != active_provider) {
+        i++;
+    }
+    i = (i + 1) % aead_provider_count();
+    active_provider = aead_provider_at(i);
+    encryption_session_resync();
+    #if IMPLICIT_NONCE
+        implicit_next_seq = 0;  // The counter of the next scenario starts at 0
+    #endif
+    frames_sealed = 0;
+    nonce_field_bytes = 0;
+    memset(nonce_latency, 0, sizeof(nonce_latency));
+    return i != 0;
+}
+
+
+void get_nonce_overhead(uint32_t *frames, uint32_t *field_bytes) {
+    *frames = frames_sealed;
+    *field_bytes = nonce_field_bytes;
+}
+
+
+void encryption_session_resync() {
+    #if ASCON_LIB_MODE && ASCON_SESSION
+        tx_session_valid = 0;
+    #endif
+    #if IMPLICIT_NONCE
+        // The retry of the last frame gets the same sequence number
+        generate_nonce(implicit_salt, sizeof(implicit_salt));
+        implicit_salt_acked = 0;
+        implicit_next_seq = implicit_last_seq;
+        #if ASCON_LIB_MODE && ASCON_USE_INIT_POOL
+            ascon_init_pool_count = 0;
+        #endif
+        #if AEAD_HAVE_AES_GCM && GCM_PRECOMPUTE
+            gcm_precomp_ready = 0;
+        #endif
+    #endif
+}
+
+
+#if AEAD_HAVE_ASCON_AUTH
+// Authentication only, the frame is values || tag || AD. The tag covers
+// direction || sequence number || values, so a frame cannot be reflected to
+// its sender or replayed under another sequence number. The keys are per
+// sensor, so the sensor id of the AD needs no binding. Up to 13 bytes of
+// readings (the 2 and 10 byte payloads) fit into Ascon-PrfShort, a single
+// permutation. Longer ones fall back to Ascon-Mac.
+#define AUTH_UPLINK 0x00    // Frames of the sensor
+#define AUTH_DOWNLINK 0x80  // Replies of the data storage
+#define AUTH_HEADER_SIZE 3
+
+static size_t auth_message(uint8_t *message, const uint8_t *data, size_t data_size,
+                           uint16_t seq_num, uint8_t direction) {
+    message[0] = direction;
+    message[1] = (uint8_t)(seq_num >> 8);
+    message[2] = (uint8_t)seq_num;
+    memcpy(message + AUTH_HEADER_SIZE, data, data_size);
+    return AUTH_HEADER_SIZE + data_size;
+}
+
+static void auth_tag(uint8_t *tag, const uint8_t *data, size_t data_size, uint16_t seq_num) {
+    uint8_t message[AUTH_HEADER_SIZE + data_size];
+    size_t len = auth_message(message, data, data_size, seq_num, AUTH_UPLINK);
+
+    if (len <= ASCON_PRFS_MAX_INBYTES) {
+        ascon_prfs(tag, message, len, key_128);
+    } else {
+        ascon_mac(tag, message, len, key_128);
+    }
+}
+
+static int auth_verify(const uint8_t *tag, const uint8_t *data, size_t data_size, uint16_t seq_num) {
+    uint8_t message[AUTH_HEADER_SIZE + data_size];
+    size_t len = auth_message(message, data, data_size, seq_num, AUTH_DOWNLINK);
+
+    if (len <= ASCON_PRFS_MAX_INBYTES) {
+        return ascon_prfs_verify(tag, message, len, key_128);
+    }
+    return ascon_mac_verify(tag, message, len, key_128);
+}
+#endif
+
+
+#if ASCON_LIB_MODE && ASCON_SESSION
+static void encrypt_session(const void *data, size_t data_size, uint8_t *output, size_t *output_len,
+                            uint8_t *nonce, const char *associated_data, size_t ad_len, uint16_t counter) {
+    uint8_t header[1 + ad_len];
+    uint64_t clen = 0;
+
+    if (!tx_session_valid || (ASCON_SESSION_RESYNC > 0 && counter % ASCON_SESSION_RESYNC == 0)) {
+        generate_nonce(nonce, CRYPTO_NPUBBYTES);
+        log_start_encryption_time(counter);
+        ascon_session_init(&tx_session, ascon_key, nonce);
+        tx_session_valid = 1;
+        header[0] = SESSION_FRAME_RESYNC;
+        nonce_field_size = CRYPTO_NPUBBYTES + 1;
+    } else {
+        log_start_encryption_time(counter);
+        header[0] = SESSION_FRAME_CHAINED;
+        nonce_field_size = 1;
+    }
+    memcpy(header + 1, associated_data, ad_len);
+
+    ascon_session_seal(&tx_session, output, &clen,
+        (const uint8_t *)data, data_size, header, sizeof(header));
+    *output_len = (size_t)clen;
+    nonce[nonce_field_size - 1] = header[0];
+
+    log_end_encryption_time(counter);
+}
+
+
+static int decrypt_session(uint8_t *decrypted_data, size_t *output_len,
+                           const uint8_t *ciphertext, size_t ciphertext_len, uint8_t type,
+                           const uint8_t *received_nonce, const char *extracted_ad, size_t ad_len) {
+    uint8_t header[1 + ad_len];
+    uint64_t mlen = 0;
+    int status = -1;
+
+    header[0] = type;
+    memcpy(header + 1, extracted_ad, ad_len);
+
+    if (type == SESSION_FRAME_RESYNC) {
+        // Only switch to the new session once its first frame authenticates
+        ascon_session_t session;
+        ascon_session_init(&session, ascon_key, received_nonce);
+        status = ascon_session_open(&session, decrypted_data, &mlen,
+            ciphertext, ciphertext_len, header, sizeof(header));
+        if (status == 0) {
+            rx_session = session;
+            rx_session_valid = 1;
+        }
+    } else if (type == SESSION_FRAME_CHAINED && rx_session_valid) {
+        status = ascon_session_open(&rx_session, decrypted_data, &mlen,
+            ciphertext, ciphertext_len, header, sizeof(header));
+    }
+    *output_len = (size_t)mlen;
+    return status;
+}
+#endif
+
+
 void encrypt(const void *data, size_t data_size, uint8_t *output, size_t *output_len,
              uint8_t *nonce, const char *associated_data, uint16_t counter) {
     size_t ad_len = strnlen(associated_data, 50);
@@ -93,25 +515,92 @@ void encrypt(const void *data, size_t data_size, uint8_t *output, size_t *output
         return;
     }
 
-    generate_nonce(nonce);
-    log_start_encryption_time(counter);
+    const aead_provider *provider = active_provider;
+    nonce_field_size = provider->NonceBytes;
+    uint8_t *npub = nonce;  // Nonce of the frame, which is also the nonce field unless it is implicit
+    #if IMPLICIT_NONCE
+    uint8_t implicit[IMPLICIT_SALT_BYTES];
+    if (provider->NonceBytes > 0) {
+        implicit_nonce(implicit, provider->NonceBytes, counter, IMPLICIT_UPLINK);
+        npub = implicit;
+        nonce_field_size = implicit_nonce_field(nonce, provider);
+        implicit_last_seq = counter;
+        implicit_next_seq = counter + 1;
+    }
+    #endif
+    frames_sealed++;
+    nonce_field_bytes += nonce_field_size;
 
-    if (SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_MASKED) {
-        unsigned long long clen = 0;
-        masked_ascon128a_encrypt(output, &clen,
+    #if ASCON_LIB_MODE && ASCON_SESSION
+    if (provider->id == ASCON_LIB_ID) {
+        encrypt_session(data, data_size, output, output_len, nonce, associated_data, ad_len, counter);
+        return;
+    }
+    #endif
+
+    #if AEAD_HAVE_ASCON_AUTH
+    if (provider->id == ENCRYPTION_ASCON_AUTH) {
+        log_start_encryption_time(counter);
+        memcpy(output, data, data_size);
+        auth_tag(output + data_size, (const uint8_t *)data, data_size, counter);
+        *output_len = data_size + TAG_SIZE;
+        log_end_encryption_time(counter);
+        return;
+    }
+    #endif
+
+    #if ASCON_LIB_MODE && ASCON_USE_INIT_POOL
+    if (provider->id == ASCON_LIB_ID && ascon_init_pool_count > 0 && npub != nonce &&
+        memcmp(ascon_init_pool[ascon_init_pool_count - 1].nonce, npub, CRYPTO_NPUBBYTES) != 0) {
+        ascon_init_pool_count = 0;  // Prepared for other sequence numbers
+    }
+    if (provider->id == ASCON_LIB_ID && ascon_init_pool_count > 0) {
+        // Nonce and initialized state come from the pool, filled while idle
+        ascon_init_entry *entry = &ascon_init_pool[--ascon_init_pool_count];
+        uint64_t clen = 0;
+        memcpy(npub, entry->nonce, sizeof(entry->nonce));
+        log_start_encryption_time(counter);
+        ascon_aead_seal_preinit(ascon_key, &entry->state, output, &clen,
             (const uint8_t *)data, data_size,
-            (const uint8_t *)associated_data, ad_len,
-            nonce);
+            (const uint8_t *)associated_data, ad_len);
         *output_len = (size_t)clen;
-    } else if (SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_UNMASKED ||
-               SELECTED_ENCRYPTION_MODE == ENCRYPTION_AES_GCM) {
+        log_end_encryption_time(counter);
+        memset(entry, 0, sizeof(*entry));
+        return;
+    }
+    #endif
+
+    #if AEAD_HAVE_AES_GCM && GCM_PRECOMPUTE
+    if (provider->id == ENCRYPTION_AES_GCM && gcm_precomp_ready && data_size <= gcm_precomp.len &&
+        (npub == nonce || memcmp(gcm_precomp.npub, npub, sizeof(gcm_precomp.npub)) == 0)) {
+        // Nonce, E(K, J0) and keystream were computed while idle
         unsigned long long clen = 0;
-        crypto_aead_encrypt(output, &clen, // Same function call for ASCON and AES
+        memcpy(npub, gcm_precomp.npub, sizeof(gcm_precomp.npub));
+        log_start_encryption_time(counter);
+        nbedtls_gcm_aead_seal_precomp(gcm_key, &gcm_precomp, output, &clen,
             (const uint8_t *)data, data_size,
-            (const uint8_t *)associated_data, ad_len,
-            NULL, nonce, key_128);
+            (const uint8_t *)associated_data, ad_len);
         *output_len = (size_t)clen;
+        log_end_encryption_time(counter);
+        gcm_precomp_ready = 0;
+        return;
     }
+    #endif
+
+    if (!provider->seal) {
+        printf("Encryption mode %d cannot seal frames!\n", provider->id);
+        return;
+    }
+
+    if (npub == nonce) {
+        generate_nonce(nonce, provider->NonceBytes);
+    }
+    log_start_encryption_time(counter);
+
+    provider->seal(provider->ctx, output, output_len,
+        (const uint8_t *)data, data_size,
+        (const uint8_t *)associated_data, ad_len,
+        npub);
 
     log_end_encryption_time(counter);
 }
@@ -160,20 +649,43 @@ int parse_unencrypted(uint8_t *received_data, size_t received_len,
 
 
 int decrypt(uint8_t *received_data, size_t received_len, uint8_t **output, size_t *output_len, uint16_t *sequence_number) {
+    const aead_provider *provider = active_provider;
 
+    if (AEAD_FRAME_ID) {
+        // Frames of a multi-provider image start with the id of their provider
+        if (received_len < 1 || (provider = aead_provider_find(received_data[0])) == NULL) {
+            printf("Error: Unknown encryption mode.\n");
+            return -1;
+        }
+        received_data++;
+        received_len--;
+    }
 
-    if (SELECTED_ENCRYPTION_MODE == ENCRYPTION_NONE) {
+    if (provider->id == ENCRYPTION_NONE) {
         return parse_unencrypted(received_data, received_len, output, output_len, sequence_number);
     }
 
-    if (received_len < (TAG_SIZE + NONCE_SIZE + 5) || received_len > MAX_PAYLOAD_SIZE) { 
+    size_t nonce_field = provider->NonceBytes;
+    size_t nonce_field_min = nonce_field;
+    #if ASCON_LIB_MODE && ASCON_SESSION
+    if (provider->id == ASCON_LIB_ID) {
+        nonce_field_min = 1;  // Type byte of a chained session frame
+    }
+    #endif
+    #if IMPLICIT_NONCE
+    if (provider->NonceBytes > 0) {
+        nonce_field = nonce_field_min = 1;  // Type byte, replies never carry a salt
+    }
+    #endif
+
+    if (received_len < (TAG_SIZE + nonce_field_min + 5) || received_len > MAX_PAYLOAD_SIZE) { 
         return -1;
     }
 
     //Locate the start of Associated Data (AD)
     size_t ad_start_index = 0;
 
-    for (size_t i = received_len - 1; i >= NONCE_SIZE; i--) {
+    for (size_t i = received_len - 1; i >= nonce_field_min && i > 0; i--) {
         if (memcmp(received_data + i, AD_PATTERN, AD_PATTERN_LEN) == 0) {
             ad_start_index = i;
             break;
@@ -208,9 +720,29 @@ int decrypt(uint8_t *received_data, size_t received_len, uint8_t **output, size_
     }
 
     //Extract Nonce
-    size_t nonce_start_index = ad_start_index - NONCE_SIZE;
-    uint8_t received_nonce[NONCE_SIZE];
-    memcpy(received_nonce, received_data + nonce_start_index, NONCE_SIZE);
+    #if ASCON_LIB_MODE && ASCON_SESSION
+    uint8_t frame_type = received_data[ad_start_index - 1];
+    if (provider->id == ASCON_LIB_ID) {
+        nonce_field = (frame_type == SESSION_FRAME_RESYNC) ? nonce_field + 1 : 1;
+        if (ad_start_index < nonce_field + TAG_SIZE) {
+            return -1;
+        }
+    }
+    #endif
+    size_t nonce_start_index = ad_start_index - nonce_field;
+    uint8_t received_nonce[AEAD_MAX_NONCE_FIELD];
+    memcpy(received_nonce, received_data + nonce_start_index,
+           (nonce_field < (size_t)provider->NonceBytes) ? nonce_field : (size_t)provider->NonceBytes);
+    #if IMPLICIT_NONCE
+    if (provider->NonceBytes > 0) {
+        // The data storage answers with the sequence number of the frame
+        if (received_data[ad_start_index - 1] != IMPLICIT_FRAME_SEQ) {
+            printf("Error: Unknown nonce field.\n");
+            return -1;
+        }
+        implicit_nonce(received_nonce, provider->NonceBytes, *sequence_number, IMPLICIT_DOWNLINK);
+    }
+    #endif
 
     size_t ciphertext_len = nonce_start_index;
     uint8_t *ciphertext = received_data;
@@ -224,30 +756,37 @@ int decrypt(uint8_t *received_data, size_t received_len, uint8_t **output, size_
 
     int status = -1;
 
-    switch (SELECTED_ENCRYPTION_MODE) {
-        case ENCRYPTION_ASCON_MASKED:
-            log_start_decryption_time(*sequence_number);
-            status = masked_ascon128a_decrypt(
-                decrypted_data, output_len,
-                ciphertext, ciphertext_len,
-                (uint8_t *)extracted_ad, ad_len,
-                received_nonce);
-            break;
-        case ENCRYPTION_ASCON_UNMASKED:
-        case ENCRYPTION_AES_GCM:
-            log_start_decryption_time(*sequence_number);
-            status = crypto_aead_decrypt(decrypted_data, output_len, // Same function call for ASCON and AES
-                NULL, ciphertext, ciphertext_len,
-                (uint8_t *)extracted_ad, ad_len,
-                received_nonce, key_128);
-            break;
-        default:
-            log_end_decryption_time(-1);
-            log_end_time(-1);
-            free(decrypted_data);
-            return -1;
+    log_start_decryption_time(*sequence_number);
+    #if ASCON_LIB_MODE && ASCON_SESSION
+    if (provider->id == ASCON_LIB_ID) {
+        status = decrypt_session(decrypted_data, output_len,
+            ciphertext, ciphertext_len, frame_type,
+            received_nonce, extracted_ad, ad_len);
+    } else
+    #endif
+    #if AEAD_HAVE_ASCON_AUTH
+    if (provider->id == ENCRYPTION_ASCON_AUTH) {
+        if (ciphertext_len >= TAG_SIZE) {
+            *output_len = ciphertext_len - TAG_SIZE;
+            memcpy(decrypted_data, ciphertext, *output_len);
+            status = auth_verify(ciphertext + *output_len, decrypted_data, *output_len, *sequence_number);
+        }
+    } else
+    #endif
+    if (provider->open) {
+        status = provider->open(provider->ctx, decrypted_data, output_len,
+            ciphertext, ciphertext_len,
+            (uint8_t *)extracted_ad, ad_len,
+            received_nonce);
     }
+
     if (status >= 0) {
+        #if IMPLICIT_NONCE
+        // The data storage has the salt, later frames leave it out
+        if (provider == active_provider) {
+            implicit_salt_acked = 1;
+        }
+        #endif
         *output = decrypted_data;
         log_end_decryption_time(*sequence_number);
         log_end_time(*sequence_number);
@@ -259,6 +798,3 @@ int decrypt(uint8_t *received_data, size_t received_len, uint8_t **output, size_
         return -1;
     }
 }
-
-
-
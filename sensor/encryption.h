@@ -11,9 +11,24 @@ void encrypt(const void *data, size_t data_size, uint8_t *output, size_t *output
     uint8_t *nonce, const char *associated_data, uint16_t counter);
 
 int decrypt(uint8_t *received_data, size_t received_len, uint8_t **output, size_t *output_len, uint16_t *sequence_number);
-void generate_nonce(uint8_t *nonce);
+void generate_nonce(uint8_t *nonce, size_t len);
 void init_primitives();
+void refill_encryption_pool();
+void encryption_session_resync();
 
 int get_nonce_size();
+int get_max_nonce_size();
+// Frames encrypted in this scenario and the bytes of their nonce fields
+void get_nonce_overhead(uint32_t *frames, uint32_t *field_bytes);
+// Source of generate_nonce() and its calls in this scenario per latency
+// bucket: below 1 us, then [1, 2), [2, 4) ... us, the last one open-ended
+#define NONCE_LATENCY_BUCKETS 8
+const char *get_nonce_source();
+void get_nonce_latency(uint32_t *counts);
+
+// Provider of encrypt() (ENCRYPTION_* of aead_provider.h), the next one of a
+// multi-provider image, 0 when it wraps to the first
+int get_encryption_mode();
+int select_next_encryption_mode();
 
 #endif // ENCRYPTION_H
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "api.h"
 #include "ascon.h"
 #include "crypto_aead.h"
@@ -26,7 +28,7 @@ forceinline void ascon_initaead(ascon_state_t* s, const ascon_key_t* key,
                                 const uint8_t* npub) {
 #if CRYPTO_KEYBYTES == 16
   if (ASCON_AEAD_RATE == 8) s->x[0] = ASCON_128_IV;
-  if (ASCON_AEAD_RATE == 16) s->x[0] = ASCON_128A_IV;
+  if (ASCON_AEAD_RATE == 16) s->x[0] = ASCON_AEAD_IV;
   s->x[1] = key->x[0];
   s->x[2] = key->x[1];
 #else /* CRYPTO_KEYBYTES == 20 */
@@ -197,31 +199,349 @@ forceinline int ascon_verify(ascon_state_t* s, const uint8_t* t) {
   return NOTZERO(s->x[3], s->x[4]);
 }
 
+forceinline void ascon_encryptblock(ascon_state_t* s, uint8_t* c,
+                                    const uint8_t* m) {
+  s->x[0] ^= LOAD(m, 8);
+  STORE(c, s->x[0], 8);
+  if (ASCON_AEAD_RATE == 16) {
+    s->x[1] ^= LOAD(m + 8, 8);
+    STORE(c + 8, s->x[1], 8);
+  }
+  printstate("absorb plaintext", s);
+  P(s, (ASCON_AEAD_RATE == 8) ? 6 : 8);
+}
+
+forceinline void ascon_decryptblock(ascon_state_t* s, uint8_t* m,
+                                    const uint8_t* c) {
+  uint64_t cx = LOAD(c, 8);
+  s->x[0] ^= cx;
+  STORE(m, s->x[0], 8);
+  s->x[0] = cx;
+  if (ASCON_AEAD_RATE == 16) {
+    cx = LOAD(c + 8, 8);
+    s->x[1] ^= cx;
+    STORE(m + 8, s->x[1], 8);
+    s->x[1] = cx;
+  }
+  printstate("insert ciphertext", s);
+  P(s, (ASCON_AEAD_RATE == 8) ? 6 : 8);
+}
+
+#if ASCON_FIXED_KERNELS
+
+forceinline void ascon_encryptfixed(ascon_state_t* s, uint8_t* c,
+                                    const uint8_t* m, const uint64_t mlen) {
+  /* mlen is constant: unroll the full blocks, the tail branches fold away */
+  const uint64_t full = mlen / ASCON_AEAD_RATE * ASCON_AEAD_RATE;
+#pragma GCC unroll 64
+  for (uint64_t i = 0; i < full; i += ASCON_AEAD_RATE)
+    ascon_encryptblock(s, c + i, m + i);
+  ascon_encrypt(s, c + full, m + full, mlen - full);
+}
+
+forceinline void ascon_decryptfixed(ascon_state_t* s, uint8_t* m,
+                                    const uint8_t* c, const uint64_t clen) {
+  const uint64_t full = clen / ASCON_AEAD_RATE * ASCON_AEAD_RATE;
+#pragma GCC unroll 64
+  for (uint64_t i = 0; i < full; i += ASCON_AEAD_RATE)
+    ascon_decryptblock(s, m + i, c + i);
+  ascon_decrypt(s, m + full, c + full, clen - full);
+}
+
+#define ASCON_DEFINE_FIXED(len)                                        \
+  void armv6m_ascon_encrypt_len##len(ascon_state_t* s, uint8_t* c,     \
+                                     const uint8_t* m) {               \
+    ascon_encryptfixed(s, c, m, len);                                  \
+  }                                                                    \
+  void armv6m_ascon_decrypt_len##len(ascon_state_t* s, uint8_t* m,     \
+                                     const uint8_t* c) {               \
+    ascon_decryptfixed(s, m, c, len);                                  \
+  }
+ASCON_FIXED_LENGTHS(ASCON_DEFINE_FIXED)
+#undef ASCON_DEFINE_FIXED
+
+#define ASCON_CASE_ENCRYPT(len)             \
+  case len:                                 \
+    armv6m_ascon_encrypt_len##len(s, c, m); \
+    return;
+#define ASCON_CASE_DECRYPT(len)             \
+  case len:                                 \
+    armv6m_ascon_decrypt_len##len(s, m, c); \
+    return;
+
+#endif
+
+forceinline void ascon_encryptmsg(ascon_state_t* s, uint8_t* c,
+                                  const uint8_t* m, uint64_t mlen) {
+#if ASCON_FIXED_KERNELS
+  switch (mlen) {
+    ASCON_FIXED_LENGTHS(ASCON_CASE_ENCRYPT)
+    default:
+      break;
+  }
+#endif
+  ascon_encrypt(s, c, m, mlen);
+}
+
+forceinline void ascon_decryptmsg(ascon_state_t* s, uint8_t* m,
+                                  const uint8_t* c, uint64_t clen) {
+#if ASCON_FIXED_KERNELS
+  switch (clen) {
+    ASCON_FIXED_LENGTHS(ASCON_CASE_DECRYPT)
+    default:
+      break;
+  }
+#endif
+  ascon_decrypt(s, m, c, clen);
+}
+
+forceinline int ascon_aead_encrypt_key(uint8_t* t, uint8_t* c,
+                                      const uint8_t* m, uint64_t mlen,
+                                      const uint8_t* ad, uint64_t adlen,
+                                      const uint8_t* npub,
+                                      const ascon_key_t* key) {
+  ascon_state_t s;
+  ascon_initaead(&s, key, npub);
+  ascon_adata(&s, ad, adlen);
+  ascon_encryptmsg(&s, c, m, mlen);
+  ascon_final(&s, key);
+  ascon_gettag(&s, t);
+  return 0;
+}
+
+forceinline int ascon_aead_decrypt_key(uint8_t* m, const uint8_t* t,
+                                      const uint8_t* c, uint64_t clen,
+                                      const uint8_t* ad, uint64_t adlen,
+                                      const uint8_t* npub,
+                                      const ascon_key_t* key) {
+  ascon_state_t s;
+  ascon_initaead(&s, key, npub);
+  ascon_adata(&s, ad, adlen);
+  ascon_decryptmsg(&s, m, c, clen);
+  ascon_final(&s, key);
+  return ascon_verify(&s, t);
+}
+
 int ascon_aead_encrypt(uint8_t* t, uint8_t* c, const uint8_t* m, uint64_t mlen,
                        const uint8_t* ad, uint64_t adlen, const uint8_t* npub,
                        const uint8_t* k) {
-  ascon_state_t s;
   ascon_key_t key;
   ascon_loadkey(&key, k);
-  ascon_initaead(&s, &key, npub);
-  ascon_adata(&s, ad, adlen);
-  ascon_encrypt(&s, c, m, mlen);
-  ascon_final(&s, &key);
-  ascon_gettag(&s, t);
-  return 0;
+  return ascon_aead_encrypt_key(t, c, m, mlen, ad, adlen, npub, &key);
 }
 
 int ascon_aead_decrypt(uint8_t* m, const uint8_t* t, const uint8_t* c,
                        uint64_t clen, const uint8_t* ad, uint64_t adlen,
                        const uint8_t* npub, const uint8_t* k) {
-  ascon_state_t s;
   ascon_key_t key;
   ascon_loadkey(&key, k);
-  ascon_initaead(&s, &key, npub);
-  ascon_adata(&s, ad, adlen);
-  ascon_decrypt(&s, m, c, clen);
-  ascon_final(&s, &key);
-  return ascon_verify(&s, t);
+  return ascon_aead_decrypt_key(m, t, c, clen, ad, adlen, npub, &key);
+}
+
+void ascon_aead_setkey(ascon_aead_keyctx_t* ctx, const uint8_t* k) {
+  ascon_loadkey(&ctx->key, k);
+}
+
+int ascon_aead_seal(const ascon_aead_keyctx_t* ctx, uint8_t* c,
+                    uint64_t* clen, const uint8_t* m, uint64_t mlen,
+                    const uint8_t* ad, uint64_t adlen, const uint8_t* npub) {
+  *clen = mlen + CRYPTO_ABYTES;
+  return ascon_aead_encrypt_key(c + mlen, c, m, mlen, ad, adlen, npub,
+                                &ctx->key);
+}
+
+void ascon_aead_preinit(const ascon_aead_keyctx_t* ctx, ascon_state_t* s,
+                        const uint8_t* npub) {
+  ascon_initaead(s, &ctx->key, npub);
+}
+
+int ascon_aead_seal_preinit(const ascon_aead_keyctx_t* ctx, ascon_state_t* s,
+                            uint8_t* c, uint64_t* clen, const uint8_t* m,
+                            uint64_t mlen, const uint8_t* ad, uint64_t adlen) {
+  *clen = mlen + CRYPTO_ABYTES;
+  ascon_adata(s, ad, adlen);
+  ascon_encryptmsg(s, c, m, mlen);
+  ascon_final(s, &ctx->key);
+  ascon_gettag(s, c + mlen);
+  return 0;
+}
+
+int ascon_aead_open(const ascon_aead_keyctx_t* ctx, uint8_t* m,
+                    uint64_t* mlen, const uint8_t* c, uint64_t clen,
+                    const uint8_t* ad, uint64_t adlen, const uint8_t* npub) {
+  if (clen < CRYPTO_ABYTES) return -1;
+  *mlen = clen - CRYPTO_ABYTES;
+  return ascon_aead_decrypt_key(m, c + *mlen, c, *mlen, ad, adlen, npub,
+                                &ctx->key);
+}
+
+void ascon_session_init(ascon_session_t* sess, const ascon_aead_keyctx_t* ctx,
+                        const uint8_t* npub) {
+  ascon_state_t* s = &sess->s;
+  /* separate sessions from the aead with the last byte of the iv */
+  s->x[0] = ASCON_AEAD_IV ^ PAD(7);
+  s->x[1] = ctx->key.x[0];
+  s->x[2] = ctx->key.x[1];
+  s->x[3] = LOAD(npub, 8);
+  s->x[4] = LOAD(npub + 8, 8);
+  printstate("session init", s);
+  P(s, 12);
+  s->x[3] ^= ctx->key.x[0];
+  s->x[4] ^= ctx->key.x[1];
+  printstate("session key xor", s);
+}
+
+forceinline void ascon_session_tag(ascon_state_t* s) {
+  P(s, 8);
+  printstate("session tag", s);
+}
+
+int ascon_session_seal(ascon_session_t* sess, uint8_t* c, uint64_t* clen,
+                       const uint8_t* m, uint64_t mlen, const uint8_t* hdr,
+                       uint64_t hdrlen) {
+  ascon_state_t* s = &sess->s;
+  *clen = mlen + CRYPTO_ABYTES;
+  ascon_adata(s, hdr, hdrlen);
+  ascon_encryptmsg(s, c, m, mlen);
+  ascon_session_tag(s);
+  STOREBYTES(c + mlen, s->x[0], 8);
+  STOREBYTES(c + mlen + 8, s->x[1], 8);
+  return 0;
+}
+
+int ascon_session_open(ascon_session_t* sess, uint8_t* m, uint64_t* mlen,
+                       const uint8_t* c, uint64_t clen, const uint8_t* hdr,
+                       uint64_t hdrlen) {
+  ascon_state_t s = sess->s;
+  if (clen < CRYPTO_ABYTES) return -1;
+  *mlen = clen - CRYPTO_ABYTES;
+  ascon_adata(&s, hdr, hdrlen);
+  ascon_decryptmsg(&s, m, c, *mlen);
+  ascon_session_tag(&s);
+  int result = NOTZERO(s.x[0] ^ LOADBYTES(c + *mlen, 8),
+                       s.x[1] ^ LOADBYTES(c + *mlen + 8, 8));
+  if (result == 0) sess->s = s;
+  return result;
+}
+
+forceinline void ascon_streamadata(ascon_aead_ctx_t* ctx) {
+  if (!ctx->adata) return;
+  /* the buffer holds the last 1..rate bytes of associated data, if any */
+  ascon_adata(&ctx->s, ctx->buf, ctx->buflen);
+  ctx->buflen = 0;
+  ctx->adata = 0;
+}
+
+void ascon_aead_init(ascon_aead_ctx_t* ctx, const uint8_t* npub,
+                     const uint8_t* k) {
+  ascon_loadkey(&ctx->key, k);
+  ascon_initaead(&ctx->s, &ctx->key, npub);
+  ctx->buflen = 0;
+  ctx->adata = 1;
+}
+
+void ascon_aead_absorb(ascon_aead_ctx_t* ctx, const uint8_t* ad,
+                       uint64_t adlen) {
+  const int nr = (ASCON_AEAD_RATE == 8) ? 6 : 8;
+  while (adlen) {
+    /* absorb a full buffer only once more data follows it */
+    if (ctx->buflen == ASCON_AEAD_RATE) {
+      ctx->s.x[0] ^= LOAD(ctx->buf, 8);
+      if (ASCON_AEAD_RATE == 16) ctx->s.x[1] ^= LOAD(ctx->buf + 8, 8);
+      printstate("absorb adata", &ctx->s);
+      P(&ctx->s, nr);
+      ctx->buflen = 0;
+    }
+    uint64_t n = ASCON_AEAD_RATE - ctx->buflen;
+    if (n > adlen) n = adlen;
+    memcpy(ctx->buf + ctx->buflen, ad, n);
+    ctx->buflen += n;
+    ad += n;
+    adlen -= n;
+  }
+}
+
+uint64_t ascon_aead_encrypt_update(ascon_aead_ctx_t* ctx, uint8_t* c,
+                                   const uint8_t* m, uint64_t mlen) {
+  uint64_t clen = 0;
+  ascon_streamadata(ctx);
+  /* complete a buffered partial block */
+  if (ctx->buflen) {
+    uint64_t n = ASCON_AEAD_RATE - ctx->buflen;
+    if (n > mlen) n = mlen;
+    memcpy(ctx->buf + ctx->buflen, m, n);
+    ctx->buflen += n;
+    m += n;
+    mlen -= n;
+    if (ctx->buflen < ASCON_AEAD_RATE) return 0;
+    ascon_encryptblock(&ctx->s, c, ctx->buf);
+    ctx->buflen = 0;
+    c += ASCON_AEAD_RATE;
+    clen += ASCON_AEAD_RATE;
+  }
+  /* full plaintext blocks */
+  while (mlen >= ASCON_AEAD_RATE) {
+    ascon_encryptblock(&ctx->s, c, m);
+    m += ASCON_AEAD_RATE;
+    c += ASCON_AEAD_RATE;
+    mlen -= ASCON_AEAD_RATE;
+    clen += ASCON_AEAD_RATE;
+  }
+  memcpy(ctx->buf, m, mlen);
+  ctx->buflen = mlen;
+  return clen;
+}
+
+uint64_t ascon_aead_decrypt_update(ascon_aead_ctx_t* ctx, uint8_t* m,
+                                   const uint8_t* c, uint64_t clen) {
+  uint64_t mlen = 0;
+  ascon_streamadata(ctx);
+  /* complete a buffered partial block */
+  if (ctx->buflen) {
+    uint64_t n = ASCON_AEAD_RATE - ctx->buflen;
+    if (n > clen) n = clen;
+    memcpy(ctx->buf + ctx->buflen, c, n);
+    ctx->buflen += n;
+    c += n;
+    clen -= n;
+    if (ctx->buflen < ASCON_AEAD_RATE) return 0;
+    ascon_decryptblock(&ctx->s, m, ctx->buf);
+    ctx->buflen = 0;
+    m += ASCON_AEAD_RATE;
+    mlen += ASCON_AEAD_RATE;
+  }
+  /* full ciphertext blocks */
+  while (clen >= ASCON_AEAD_RATE) {
+    ascon_decryptblock(&ctx->s, m, c);
+    m += ASCON_AEAD_RATE;
+    c += ASCON_AEAD_RATE;
+    clen -= ASCON_AEAD_RATE;
+    mlen += ASCON_AEAD_RATE;
+  }
+  memcpy(ctx->buf, c, clen);
+  ctx->buflen = clen;
+  return mlen;
+}
+
+uint64_t ascon_aead_encrypt_final(ascon_aead_ctx_t* ctx, uint8_t* c,
+                                  uint8_t* t) {
+  ascon_streamadata(ctx);
+  uint64_t clen = ctx->buflen;
+  ascon_encrypt(&ctx->s, c, ctx->buf, clen);
+  ascon_final(&ctx->s, &ctx->key);
+  ascon_gettag(&ctx->s, t);
+  ctx->buflen = 0;
+  return clen;
+}
+
+int ascon_aead_decrypt_final(ascon_aead_ctx_t* ctx, uint8_t* m,
+                             uint64_t* mlen, const uint8_t* t) {
+  ascon_streamadata(ctx);
+  *mlen = ctx->buflen;
+  ascon_decrypt(&ctx->s, m, ctx->buf, ctx->buflen);
+  ascon_final(&ctx->s, &ctx->key);
+  ctx->buflen = 0;
+  return ascon_verify(&ctx->s, t);
 }
 
 int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
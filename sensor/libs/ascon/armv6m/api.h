@@ -5,3 +5,6 @@
 #define CRYPTO_ABYTES 16
 #define CRYPTO_NOOVERLAP 1
 #define ASCON_AEAD_RATE 16
+#define ASCON_HASH_BYTES 0 /* xof */
+#define ASCON_HASH_ROUNDS 12
+#define ASCON_PRF_ROUNDS 12
@@ -6,6 +6,61 @@
 #include "api.h"
 #include "config.h"
 
+/* the library shares an image with ascon-suite (ASCON_MASKED), which has
+ * its own ascon_xof, ascon_prf, ascon_mac and more, so every function of the
+ * library is linked with the armv6m_ prefix */
+#define ascon_absorb              armv6m_ascon_absorb
+#define ascon_absorbprf           armv6m_ascon_absorbprf
+#define ascon_adata               armv6m_ascon_adata
+#define ascon_aead_absorb         armv6m_ascon_aead_absorb
+#define ascon_aead_decrypt        armv6m_ascon_aead_decrypt
+#define ascon_aead_decrypt_final  armv6m_ascon_aead_decrypt_final
+#define ascon_aead_decrypt_key    armv6m_ascon_aead_decrypt_key
+#define ascon_aead_decrypt_update armv6m_ascon_aead_decrypt_update
+#define ascon_aead_encrypt        armv6m_ascon_aead_encrypt
+#define ascon_aead_encrypt_final  armv6m_ascon_aead_encrypt_final
+#define ascon_aead_encrypt_key    armv6m_ascon_aead_encrypt_key
+#define ascon_aead_encrypt_update armv6m_ascon_aead_encrypt_update
+#define ascon_aead_init           armv6m_ascon_aead_init
+#define ascon_aead_open           armv6m_ascon_aead_open
+#define ascon_aead_preinit        armv6m_ascon_aead_preinit
+#define ascon_aead_seal           armv6m_ascon_aead_seal
+#define ascon_aead_seal_preinit   armv6m_ascon_aead_seal_preinit
+#define ascon_aead_setkey         armv6m_ascon_aead_setkey
+#define ascon_decrypt             armv6m_ascon_decrypt
+#define ascon_decryptblock        armv6m_ascon_decryptblock
+#define ascon_decryptfixed        armv6m_ascon_decryptfixed
+#define ascon_decryptmsg          armv6m_ascon_decryptmsg
+#define ascon_drbg_generate       armv6m_ascon_drbg_generate
+#define ascon_drbg_refill         armv6m_ascon_drbg_refill
+#define ascon_drbg_reseed         armv6m_ascon_drbg_reseed
+#define ascon_drbg_seed           armv6m_ascon_drbg_seed
+#define ascon_encrypt             armv6m_ascon_encrypt
+#define ascon_encryptblock        armv6m_ascon_encryptblock
+#define ascon_encryptfixed        armv6m_ascon_encryptfixed
+#define ascon_encryptmsg          armv6m_ascon_encryptmsg
+#define ascon_final               armv6m_ascon_final
+#define ascon_gettag              armv6m_ascon_gettag
+#define ascon_initaead            armv6m_ascon_initaead
+#define ascon_inithash            armv6m_ascon_inithash
+#define ascon_initprf             armv6m_ascon_initprf
+#define ascon_loadkey             armv6m_ascon_loadkey
+#define ascon_mac                 armv6m_ascon_mac
+#define ascon_mac_verify          armv6m_ascon_mac_verify
+#define ascon_prf                 armv6m_ascon_prf
+#define ascon_prfs                armv6m_ascon_prfs
+#define ascon_prfs_state          armv6m_ascon_prfs_state
+#define ascon_prfs_verify         armv6m_ascon_prfs_verify
+#define ascon_session_init        armv6m_ascon_session_init
+#define ascon_session_open        armv6m_ascon_session_open
+#define ascon_session_seal        armv6m_ascon_session_seal
+#define ascon_session_tag         armv6m_ascon_session_tag
+#define ascon_squeeze             armv6m_ascon_squeeze
+#define ascon_squeezeprf          armv6m_ascon_squeezeprf
+#define ascon_streamadata         armv6m_ascon_streamadata
+#define ascon_verify              armv6m_ascon_verify
+#define ascon_xof                 armv6m_ascon_xof
+
 typedef union {
   uint64_t x[5];
   uint32_t w[5][2];
@@ -43,6 +98,79 @@ int ascon_aead_decrypt(uint8_t* m, const uint8_t* t, const uint8_t* c,
                        uint64_t clen, const uint8_t* ad, uint64_t adlen,
                        const uint8_t* npub, const uint8_t* k);
 
+/* aead with a key that is loaded once, c holds the ciphertext and tag */
+typedef struct {
+  ascon_key_t key;
+} ascon_aead_keyctx_t;
+
+void ascon_aead_setkey(ascon_aead_keyctx_t* ctx, const uint8_t* k);
+int ascon_aead_seal(const ascon_aead_keyctx_t* ctx, uint8_t* c,
+                    uint64_t* clen, const uint8_t* m, uint64_t mlen,
+                    const uint8_t* ad, uint64_t adlen, const uint8_t* npub);
+int ascon_aead_open(const ascon_aead_keyctx_t* ctx, uint8_t* m,
+                    uint64_t* mlen, const uint8_t* c, uint64_t clen,
+                    const uint8_t* ad, uint64_t adlen, const uint8_t* npub);
+/* split seal: the key/nonce initialization can run ahead of time */
+void ascon_aead_preinit(const ascon_aead_keyctx_t* ctx, ascon_state_t* s,
+                        const uint8_t* npub);
+int ascon_aead_seal_preinit(const ascon_aead_keyctx_t* ctx, ascon_state_t* s,
+                            uint8_t* c, uint64_t* clen, const uint8_t* m,
+                            uint64_t mlen, const uint8_t* ad, uint64_t adlen);
+
+/* session (keyed duplex): one initialization, then the state carries over
+ * from frame to frame, each frame absorbs a header, encrypts and squeezes a
+ * tag after a single P8; a new session (nonce) resynchronizes both sides */
+typedef struct {
+  ascon_state_t s;
+} ascon_session_t;
+
+void ascon_session_init(ascon_session_t* sess, const ascon_aead_keyctx_t* ctx,
+                        const uint8_t* npub);
+int ascon_session_seal(ascon_session_t* sess, uint8_t* c, uint64_t* clen,
+                       const uint8_t* m, uint64_t mlen, const uint8_t* hdr,
+                       uint64_t hdrlen);
+/* the state only advances if the tag is valid */
+int ascon_session_open(ascon_session_t* sess, uint8_t* m, uint64_t* mlen,
+                       const uint8_t* c, uint64_t clen, const uint8_t* hdr,
+                       uint64_t hdrlen);
+
+#if ASCON_FIXED_KERNELS
+/* kernels for the lengths in ASCON_FIXED_LENGTHS, without loops or tail
+ * branches, the one-shot, keyed and session functions dispatch to them */
+#define ASCON_DECLARE_FIXED(len)                                        \
+  void armv6m_ascon_encrypt_len##len(ascon_state_t* s, uint8_t* c,      \
+                                     const uint8_t* m);                 \
+  void armv6m_ascon_decrypt_len##len(ascon_state_t* s, uint8_t* m,      \
+                                     const uint8_t* c);
+ASCON_FIXED_LENGTHS(ASCON_DECLARE_FIXED)
+#undef ASCON_DECLARE_FIXED
+#endif
+
+/* incremental aead: init, absorb (ad), update (m or c) and final */
+typedef struct {
+  ascon_state_t s;
+  ascon_key_t key;
+  uint8_t buf[ASCON_AEAD_RATE];
+  uint8_t buflen;
+  uint8_t adata;
+} ascon_aead_ctx_t;
+
+void ascon_aead_init(ascon_aead_ctx_t* ctx, const uint8_t* npub,
+                     const uint8_t* k);
+void ascon_aead_absorb(ascon_aead_ctx_t* ctx, const uint8_t* ad,
+                       uint64_t adlen);
+/* update functions return the number of output bytes written, which is a
+ * multiple of the rate and at most len + ASCON_AEAD_RATE - 1 */
+uint64_t ascon_aead_encrypt_update(ascon_aead_ctx_t* ctx, uint8_t* c,
+                                   const uint8_t* m, uint64_t mlen);
+uint64_t ascon_aead_decrypt_update(ascon_aead_ctx_t* ctx, uint8_t* m,
+                                   const uint8_t* c, uint64_t clen);
+/* final functions write the last partial block (< ASCON_AEAD_RATE bytes) */
+uint64_t ascon_aead_encrypt_final(ascon_aead_ctx_t* ctx, uint8_t* c,
+                                  uint8_t* t);
+int ascon_aead_decrypt_final(ascon_aead_ctx_t* ctx, uint8_t* m,
+                             uint64_t* mlen, const uint8_t* t);
+
 #endif
 
 #ifdef ASCON_HASH_BYTES
@@ -55,8 +183,50 @@ void ascon_squeeze(ascon_state_t* s, uint8_t* out, uint64_t outlen);
 
 #endif
 
+/* Ascon-XOF v1.2, or Ascon-XOF128 (SP 800-232) with ASCON_VARIANT_AEAD128 */
 int ascon_xof(uint8_t* out, uint64_t outlen, const uint8_t* in, uint64_t inlen);
 
+/* deterministic random bit generator on the xof sponge: the seed is absorbed
+ * like xof input, output is squeezed ASCON_DRBG_BYTES at a time into buf and
+ * 128 bits of the state are cleared after every refill. The first
+ * ASCON_DRBG_BYTES after ascon_drbg_seed equal ascon_xof of the seed. */
+#define ASCON_DRBG_BYTES 64
+
+typedef struct {
+  ascon_state_t s;
+  uint8_t buf[ASCON_DRBG_BYTES];
+  uint32_t pos;     /* next unused byte of buf */
+  uint32_t refills; /* since the last (re)seed */
+} ascon_drbg_t;
+
+void ascon_drbg_seed(ascon_drbg_t* d, const uint8_t* seed, uint64_t seedlen);
+void ascon_drbg_reseed(ascon_drbg_t* d, const uint8_t* seed,
+                       uint64_t seedlen);
+/* squeezes the next ASCON_DRBG_BYTES, unused bytes of buf are dropped */
+void ascon_drbg_refill(ascon_drbg_t* d);
+/* copies from buf, refills when it runs out */
+void ascon_drbg_generate(ascon_drbg_t* d, uint8_t* out, uint64_t outlen);
+
+#endif
+
+#if defined(ASCON_PRF_ROUNDS) && ASCON_VARIANT == ASCON_VARIANT_128A
+
+/* Ascon-PrfShort takes at most 16 input bytes */
+#define ASCON_PRFS_MAX_INBYTES 16
+
+/* keyed functions of Ascon v1.2 (CRYPTO_KEYBYTES key): Ascon-Prf with any
+ * output length, Ascon-Mac and Ascon-PrfShort with a 16 byte tag, verify
+ * returns 0 if the tag is valid and -1 otherwise */
+int ascon_prf(uint8_t* out, uint64_t outlen, const uint8_t* in,
+              uint64_t inlen, const uint8_t* k);
+int ascon_mac(uint8_t* t, const uint8_t* in, uint64_t inlen, const uint8_t* k);
+int ascon_mac_verify(const uint8_t* t, const uint8_t* in, uint64_t inlen,
+                     const uint8_t* k);
+int ascon_prfs(uint8_t* t, const uint8_t* in, uint64_t inlen,
+               const uint8_t* k);
+int ascon_prfs_verify(const uint8_t* t, const uint8_t* in, uint64_t inlen,
+                      const uint8_t* k);
+
 #endif
 
 #endif /* ASCON_H_ */
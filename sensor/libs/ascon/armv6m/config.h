@@ -16,4 +16,39 @@
 #define ASCON_UNROLL_LOOPS 0
 #endif
 
+/* permutation backends */
+#define ASCON_BACKEND_ARMV6M 0
+#define ASCON_BACKEND_OPT64 1
+#define ASCON_BACKEND_BI32 2
+
+/* select the permutation backend, default to thumb-1 assembly on armv6m */
+#ifndef ASCON_BACKEND
+#if defined(__thumb__) && !defined(__thumb2__)
+#define ASCON_BACKEND ASCON_BACKEND_ARMV6M
+#else
+#define ASCON_BACKEND ASCON_BACKEND_OPT64
+#endif
+#endif
+
+/* aead variants */
+#define ASCON_VARIANT_128A 0
+#define ASCON_VARIANT_AEAD128 1
+
+/* select the aead variant: pre-standard Ascon-128a v1.2 (big-endian words)
+ * or NIST SP 800-232 Ascon-AEAD128 (little-endian words) */
+#ifndef ASCON_VARIANT
+#define ASCON_VARIANT ASCON_VARIANT_128A
+#endif
+
+/* straight-line encrypt/decrypt kernels for fixed message lengths */
+#ifndef ASCON_FIXED_KERNELS
+#define ASCON_FIXED_KERNELS 0
+#endif
+
+/* kernel message lengths, default to the sensor payloads of 1, 5, 50 and 100
+ * readings, other lengths use the generic loops */
+#ifndef ASCON_FIXED_LENGTHS
+#define ASCON_FIXED_LENGTHS(X) X(2) X(10) X(100) X(200)
+#endif
+
 #endif /* CONFIG_H_ */
@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+#include "config.h"
+
 #define ASCON_128_KEYBYTES 16
 #define ASCON_128A_KEYBYTES 16
 #define ASCON_80PQ_KEYBYTES 20
@@ -29,8 +31,85 @@
 #define ASCON_PRFA_PA_ROUNDS 12
 #define ASCON_PRFA_PB_ROUNDS 8
 
+#if ASCON_BACKEND == ASCON_BACKEND_BI32
+
+/* bit-interleaved constants: even bits in the low and odd bits in the high
+ * word, round constants hold the even bits in the low nibble */
+
+#define ASCON_128_IV 0x8021000008220000ull
+#define ASCON_128A_IV 0x8822000000200000ull
+#define ASCON_AEAD128_IV 0x00008a0000400201ull
+#define ASCON_80PQ_IV 0xc021000008220000ull
+
+#define ASCON_HASH_IV 0x0020000008200010ull
+#define ASCON_HASHA_IV 0x0020000008220010ull
+#define ASCON_XOF_IV 0x0020000008200000ull
+#define ASCON_XOFA_IV 0x0020000008220000ull
+
+#define ASCON_HASH_IV0 0xf9afb5c6a540dbc7ull
+#define ASCON_HASH_IV1 0xbd2493011445a340ull
+#define ASCON_HASH_IV2 0xcb9ba8b5604d4fc8ull
+#define ASCON_HASH_IV3 0x12a4eede94514c98ull
+#define ASCON_HASH_IV4 0x4bca84c06339f398ull
+
+#define ASCON_HASHA_IV0 0x0108e46d1b16eb02ull
+#define ASCON_HASHA_IV1 0x5b9b8efdd29083f3ull
+#define ASCON_HASHA_IV2 0x7ad665622891ae4aull
+#define ASCON_HASHA_IV3 0x9dc27156ee3bfc7full
+#define ASCON_HASHA_IV4 0xc61d5fa916801633ull
+
+#define ASCON_XOF_IV0 0xc75782817e351ae6ull
+#define ASCON_XOF_IV1 0x70045f441d238220ull
+#define ASCON_XOF_IV2 0x5dd5ab52a13e3f04ull
+#define ASCON_XOF_IV3 0x3e378142c30c1db2ull
+#define ASCON_XOF_IV4 0x3735189db624d656ull
+
+#define ASCON_XOFA_IV0 0x0846d7a5a4b87d44ull
+#define ASCON_XOFA_IV1 0xaa6f1005b3a2dbf4ull
+#define ASCON_XOFA_IV2 0xdc451146f713e811ull
+#define ASCON_XOFA_IV3 0x468cb2532839e30dull
+#define ASCON_XOFA_IV4 0xeb2d429709e96977ull
+
+#define ASCON_XOF128_IV0 0xb9b5a81fc0ae36b9ull
+#define ASCON_XOF128_IV1 0xa6d933e6aeabf6d9ull
+#define ASCON_XOF128_IV2 0xd0b98214bc3f00e5ull
+#define ASCON_XOF128_IV3 0x3cf1072a288d99caull
+#define ASCON_XOF128_IV4 0xc044b73b8ef2db1eull
+
+#define ASCON_MAC_IV 0x88a0000800200000ull
+#define ASCON_MACA_IV 0x88a0000800220000ull
+#define ASCON_PRF_IV 0x88a0000000200000ull
+#define ASCON_PRFA_IV 0x88a0000000220000ull
+#define ASCON_PRFS_IV 0x8028000000a00000ull
+
+#define RC0 0xcc
+#define RC1 0xc9
+#define RC2 0x9c
+#define RC3 0x99
+#define RC4 0xc6
+#define RC5 0xc3
+#define RC6 0x96
+#define RC7 0x93
+#define RC8 0x6c
+#define RC9 0x69
+#define RCa 0x3c
+#define RCb 0x39
+
+/* even and odd round constant nibbles packed by round index */
+#define RC_E 0x9c9c36369c9cull
+#define RC_O 0x336699cc99ccull
+
+#define RC(i) ((RC_E >> (4 * (i)) & 0xf) | (RC_O >> (4 * (i)) & 0xf) << 4)
+
+#define START(n) (12 - (n))
+#define INC 1
+#define END 12
+
+#else /* !ASCON_BACKEND_BI32 */
+
 #define ASCON_128_IV 0x80400c0600000000ull
 #define ASCON_128A_IV 0x80800c0800000000ull
+#define ASCON_AEAD128_IV 0x00001000808c0001ull
 #define ASCON_80PQ_IV 0xa0400c0600000000ull
 
 #define ASCON_HASH_IV 0x00400c0000000100ull
@@ -62,6 +141,12 @@
 #define ASCON_XOFA_IV3 0x246885e1de0d225bull
 #define ASCON_XOFA_IV4 0xa8cb5ce33449973full
 
+#define ASCON_XOF128_IV0 0xda82ce768d9447ebull
+#define ASCON_XOF128_IV1 0xcc7ce6c75f1ef969ull
+#define ASCON_XOF128_IV2 0xe7508fd780085631ull
+#define ASCON_XOF128_IV3 0x0ee0ea53416b58ccull
+#define ASCON_XOF128_IV4 0xe0547524db6f0bdeull
+
 #define ASCON_MAC_IV 0x80808c0000000080ull
 #define ASCON_MACA_IV 0x80808c0400000080ull
 #define ASCON_PRF_IV 0x80808c0000000000ull
@@ -87,4 +172,13 @@
 #define INC -0x0f
 #define END 0x3c
 
+#endif
+
+/* iv of the selected rate 16 aead variant */
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+#define ASCON_AEAD_IV ASCON_AEAD128_IV
+#else
+#define ASCON_AEAD_IV ASCON_128A_IV
+#endif
+
 #endif /* CONSTANTS_H_ */
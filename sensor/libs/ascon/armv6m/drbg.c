@@ -0,0 +1,82 @@
+#include <string.h>
+
+#include "api.h"
+#include "ascon.h"
+#include "permutations.h"
+#include "printstate.h"
+
+#ifdef ASCON_HASH_BYTES
+
+static void ascon_drbg_absorb(ascon_state_t* s, const uint8_t* in,
+                              uint64_t inlen) {
+  /* full input blocks, as ascon_absorb */
+  while (inlen >= ASCON_HASH_RATE) {
+    s->x[0] ^= LOAD(in, 8);
+    P(s, ASCON_HASH_ROUNDS);
+    in += ASCON_HASH_RATE;
+    inlen -= ASCON_HASH_RATE;
+  }
+  /* final input block */
+  s->x[0] ^= PAD(inlen);
+  if (inlen) s->x[0] ^= LOADBYTES(in, inlen);
+  printstate("absorb seed", s);
+}
+
+void ascon_drbg_seed(ascon_drbg_t* d, const uint8_t* seed, uint64_t seedlen) {
+  /* the initial state of the xof, so the first refill is the xof of the seed */
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+  const uint64_t iv[5] = {ASCON_XOF128_IV0, ASCON_XOF128_IV1, ASCON_XOF128_IV2,
+                          ASCON_XOF128_IV3, ASCON_XOF128_IV4};
+#elif ASCON_HASH_ROUNDS == 12
+  const uint64_t iv[5] = {ASCON_XOF_IV0, ASCON_XOF_IV1, ASCON_XOF_IV2,
+                          ASCON_XOF_IV3, ASCON_XOF_IV4};
+#else /* ASCON_HASH_ROUNDS == 8 */
+  const uint64_t iv[5] = {ASCON_XOFA_IV0, ASCON_XOFA_IV1, ASCON_XOFA_IV2,
+                          ASCON_XOFA_IV3, ASCON_XOFA_IV4};
+#endif
+  for (int i = 0; i < 5; ++i) d->s.x[i] = iv[i];
+  ascon_drbg_absorb(&d->s, seed, seedlen);
+  memset(d->buf, 0, sizeof(d->buf));
+  d->pos = ASCON_DRBG_BYTES;
+  d->refills = 0;
+}
+
+void ascon_drbg_reseed(ascon_drbg_t* d, const uint8_t* seed,
+                       uint64_t seedlen) {
+  /* the buffered output is dropped, later output depends on the new seed */
+  ascon_drbg_absorb(&d->s, seed, seedlen);
+  memset(d->buf, 0, sizeof(d->buf));
+  d->pos = ASCON_DRBG_BYTES;
+  d->refills = 0;
+}
+
+void ascon_drbg_refill(ascon_drbg_t* d) {
+  P(&d->s, 12);
+  for (int i = 0; i < ASCON_DRBG_BYTES; i += ASCON_HASH_RATE) {
+    STORE(d->buf + i, d->s.x[0], 8);
+    P(&d->s, ASCON_HASH_ROUNDS);
+  }
+  /* forget 128 bits of the state, so a leaked state does not give the
+   * output of this or earlier refills */
+  d->s.x[0] = 0;
+  d->s.x[1] = 0;
+  printstate("refill", &d->s);
+  d->pos = 0;
+  d->refills++;
+}
+
+void ascon_drbg_generate(ascon_drbg_t* d, uint8_t* out, uint64_t outlen) {
+  while (outlen) {
+    if (d->pos == ASCON_DRBG_BYTES) ascon_drbg_refill(d);
+    uint32_t n = ASCON_DRBG_BYTES - d->pos;
+    if (n > outlen) n = (uint32_t)outlen;
+    memcpy(out, d->buf + d->pos, n);
+    /* output is handed out once */
+    memset(d->buf + d->pos, 0, n);
+    d->pos += n;
+    out += n;
+    outlen -= n;
+  }
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include "api.h"
+#include "ascon.h"
+#include "permutations.h"
+#include "printstate.h"
+
+#if !ASCON_INLINE_MODE
+#undef forceinline
+#define forceinline
+#endif
+
+#ifdef ASCON_HASH_BYTES
+
+forceinline void ascon_inithash(ascon_state_t* s) {
+  /* precomputed initial state: P12 of the iv and a zero state */
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+  const uint64_t iv[5] = {ASCON_XOF128_IV0, ASCON_XOF128_IV1, ASCON_XOF128_IV2,
+                          ASCON_XOF128_IV3, ASCON_XOF128_IV4};
+#elif ASCON_HASH_ROUNDS == 12
+  const uint64_t iv[5] = {ASCON_XOF_IV0, ASCON_XOF_IV1, ASCON_XOF_IV2,
+                          ASCON_XOF_IV3, ASCON_XOF_IV4};
+#else /* ASCON_HASH_ROUNDS == 8 */
+  const uint64_t iv[5] = {ASCON_XOFA_IV0, ASCON_XOFA_IV1, ASCON_XOFA_IV2,
+                          ASCON_XOFA_IV3, ASCON_XOFA_IV4};
+#endif
+  for (int i = 0; i < 5; ++i) s->x[i] = iv[i];
+  printstate("initialization", s);
+}
+
+forceinline void ascon_absorb(ascon_state_t* s, const uint8_t* in,
+                              uint64_t inlen) {
+  /* full input blocks */
+  while (inlen >= ASCON_HASH_RATE) {
+    s->x[0] ^= LOAD(in, 8);
+    printstate("absorb input", s);
+    P(s, ASCON_HASH_ROUNDS);
+    in += ASCON_HASH_RATE;
+    inlen -= ASCON_HASH_RATE;
+  }
+  /* final input block */
+  s->x[0] ^= PAD(inlen);
+  if (inlen) s->x[0] ^= LOADBYTES(in, inlen);
+  printstate("pad input", s);
+}
+
+forceinline void ascon_squeeze(ascon_state_t* s, uint8_t* out,
+                               uint64_t outlen) {
+  /* full output blocks */
+  P(s, 12);
+  while (outlen > ASCON_HASH_RATE) {
+    STORE(out, s->x[0], 8);
+    printstate("squeeze output", s);
+    P(s, ASCON_HASH_ROUNDS);
+    out += ASCON_HASH_RATE;
+    outlen -= ASCON_HASH_RATE;
+  }
+  /* final output block */
+  STOREBYTES(out, s->x[0], outlen);
+  printstate("squeeze output", s);
+}
+
+int ascon_xof(uint8_t* out, uint64_t outlen, const uint8_t* in,
+              uint64_t inlen) {
+  ascon_state_t s;
+  ascon_inithash(&s);
+  ascon_absorb(&s, in, inlen);
+  ascon_squeeze(&s, out, outlen);
+  return 0;
+}
+
+#endif
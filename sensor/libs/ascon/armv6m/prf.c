@@ -0,0 +1,141 @@
+#include "api.h"
+#include "ascon.h"
+#include "permutations.h"
+#include "printstate.h"
+
+#if !ASCON_INLINE_MODE
+#undef forceinline
+#define forceinline
+#endif
+
+#if defined(ASCON_PRF_ROUNDS) && ASCON_VARIANT == ASCON_VARIANT_128A
+
+forceinline void ascon_initprf(ascon_state_t* s, const uint8_t* k,
+                               uint64_t iv) {
+  s->x[0] = iv;
+  s->x[1] = LOAD(k, 8);
+  s->x[2] = LOAD(k + 8, 8);
+  s->x[3] = 0;
+  s->x[4] = 0;
+  printstate("initial value", s);
+  P(s, 12);
+  printstate("initialization", s);
+}
+
+forceinline void ascon_absorbprf(ascon_state_t* s, const uint8_t* in,
+                                 uint64_t inlen) {
+  /* full input blocks, the rate covers x0..x3 */
+  while (inlen >= ASCON_PRF_IN_RATE) {
+    s->x[0] ^= LOAD(in, 8);
+    s->x[1] ^= LOAD(in + 8, 8);
+    s->x[2] ^= LOAD(in + 16, 8);
+    s->x[3] ^= LOAD(in + 24, 8);
+    printstate("absorb input", s);
+    P(s, ASCON_PRF_ROUNDS);
+    in += ASCON_PRF_IN_RATE;
+    inlen -= ASCON_PRF_IN_RATE;
+  }
+  /* final input block */
+  uint64_t* px = &s->x[0];
+  while (inlen >= 8) {
+    *px++ ^= LOAD(in, 8);
+    in += 8;
+    inlen -= 8;
+  }
+  *px ^= PAD(inlen);
+  if (inlen) *px ^= LOADBYTES(in, inlen);
+  printstate("pad input", s);
+  /* domain separation */
+  s->x[4] ^= DSEP();
+  printstate("domain separation", s);
+}
+
+forceinline void ascon_squeezeprf(ascon_state_t* s, uint8_t* out,
+                                  uint64_t outlen) {
+  /* full output blocks */
+  P(s, 12);
+  while (outlen > ASCON_PRF_OUT_RATE) {
+    STORE(out, s->x[0], 8);
+    STORE(out + 8, s->x[1], 8);
+    printstate("squeeze output", s);
+    P(s, ASCON_PRF_ROUNDS);
+    out += ASCON_PRF_OUT_RATE;
+    outlen -= ASCON_PRF_OUT_RATE;
+  }
+  /* final output block */
+  if (outlen > 8) {
+    STORE(out, s->x[0], 8);
+    STOREBYTES(out + 8, s->x[1], outlen - 8);
+  } else {
+    STOREBYTES(out, s->x[0], outlen);
+  }
+  printstate("squeeze output", s);
+}
+
+int ascon_prf(uint8_t* out, uint64_t outlen, const uint8_t* in,
+              uint64_t inlen, const uint8_t* k) {
+  ascon_state_t s;
+  ascon_initprf(&s, k, ASCON_PRF_ROUNDS == 12 ? ASCON_PRF_IV : ASCON_PRFA_IV);
+  ascon_absorbprf(&s, in, inlen);
+  ascon_squeezeprf(&s, out, outlen);
+  return 0;
+}
+
+int ascon_mac(uint8_t* t, const uint8_t* in, uint64_t inlen,
+              const uint8_t* k) {
+  ascon_state_t s;
+  ascon_initprf(&s, k, ASCON_PRF_ROUNDS == 12 ? ASCON_MAC_IV : ASCON_MACA_IV);
+  ascon_absorbprf(&s, in, inlen);
+  ascon_squeezeprf(&s, t, ASCON_PRF_OUT_RATE);
+  return 0;
+}
+
+int ascon_mac_verify(const uint8_t* t, const uint8_t* in, uint64_t inlen,
+                     const uint8_t* k) {
+  ascon_state_t s;
+  ascon_initprf(&s, k, ASCON_PRF_ROUNDS == 12 ? ASCON_MAC_IV : ASCON_MACA_IV);
+  ascon_absorbprf(&s, in, inlen);
+  P(&s, 12);
+  /* verify should be constant time, check compiler output */
+  s.x[0] ^= LOADBYTES(t, 8);
+  s.x[1] ^= LOADBYTES(t + 8, 8);
+  return NOTZERO(s.x[0], s.x[1]);
+}
+
+forceinline void ascon_prfs_state(ascon_state_t* s, const uint8_t* in,
+                                  uint64_t inlen, const uint8_t* k) {
+  /* single permutation, the input length is part of the iv */
+  s->x[0] = ASCON_PRFS_IV ^ PRFS_MLEN(inlen);
+  s->x[1] = LOAD(k, 8);
+  s->x[2] = LOAD(k + 8, 8);
+  s->x[3] = inlen ? LOADBYTES(in, inlen > 8 ? 8 : inlen) : 0;
+  s->x[4] = inlen > 8 ? LOADBYTES(in + 8, inlen - 8) : 0;
+  printstate("initial value", s);
+  P(s, 12);
+  s->x[3] ^= LOAD(k, 8);
+  s->x[4] ^= LOAD(k + 8, 8);
+  printstate("final key xor", s);
+}
+
+int ascon_prfs(uint8_t* t, const uint8_t* in, uint64_t inlen,
+               const uint8_t* k) {
+  ascon_state_t s;
+  if (inlen > ASCON_PRFS_MAX_INBYTES) return -1;
+  ascon_prfs_state(&s, in, inlen, k);
+  STORE(t, s.x[3], 8);
+  STORE(t + 8, s.x[4], 8);
+  return 0;
+}
+
+int ascon_prfs_verify(const uint8_t* t, const uint8_t* in, uint64_t inlen,
+                      const uint8_t* k) {
+  ascon_state_t s;
+  if (inlen > ASCON_PRFS_MAX_INBYTES) return -1;
+  ascon_prfs_state(&s, in, inlen, k);
+  /* verify should be constant time, check compiler output */
+  s.x[3] ^= LOADBYTES(t, 8);
+  s.x[4] ^= LOADBYTES(t + 8, 8);
+  return NOTZERO(s.x[3], s.x[4]);
+}
+
+#endif
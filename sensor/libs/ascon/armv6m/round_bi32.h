@@ -0,0 +1,74 @@
+#ifndef ROUND_BI32_H_
+#define ROUND_BI32_H_
+
+#include "ascon.h"
+#include "constants.h"
+#include "forceinline.h"
+#include "printstate.h"
+#include "word.h"
+
+/* s-box on one 32-bit slice of the state */
+#define SBOX32(x0, x1, x2, x3, x4)       \
+  do {                                   \
+    uint32_t t0, t1, t2, t3, t4;         \
+    x0 ^= x4;                            \
+    x4 ^= x3;                            \
+    x2 ^= x1;                            \
+    t0 = x0 ^ (~x1 & x2);                \
+    t2 = x2 ^ (~x3 & x4);                \
+    t4 = x4 ^ (~x0 & x1);                \
+    t1 = x1 ^ (~x2 & x3);                \
+    t3 = x3 ^ (~x4 & x0);                \
+    x1 = t1 ^ t0;                        \
+    x3 = t3 ^ t2;                        \
+    x0 = t0 ^ t4;                        \
+    x2 = ~t2;                            \
+    x4 = t4;                             \
+  } while (0)
+
+forceinline void ROUND(ascon_state_t* s, uint8_t C) {
+  uint32_t e0 = (uint32_t)s->x[0], o0 = (uint32_t)(s->x[0] >> 32);
+  uint32_t e1 = (uint32_t)s->x[1], o1 = (uint32_t)(s->x[1] >> 32);
+  uint32_t e2 = (uint32_t)s->x[2], o2 = (uint32_t)(s->x[2] >> 32);
+  uint32_t e3 = (uint32_t)s->x[3], o3 = (uint32_t)(s->x[3] >> 32);
+  uint32_t e4 = (uint32_t)s->x[4], o4 = (uint32_t)(s->x[4] >> 32);
+  uint32_t te, to;
+  /* round constant */
+  e2 ^= C & 0x0f;
+  o2 ^= C >> 4;
+  /* s-box layer */
+  SBOX32(e0, e1, e2, e3, e4);
+  SBOX32(o0, o1, o2, o3, o4);
+  /* linear layer, rotations by 19/28, 61/39, 1/6, 10/17 and 7/41 */
+  te = e0 ^ ROR32(o0, 9) ^ ROR32(e0, 14);
+  to = o0 ^ ROR32(e0, 10) ^ ROR32(o0, 14);
+  e0 = te, o0 = to;
+  te = e1 ^ ROR32(o1, 30) ^ ROR32(o1, 19);
+  to = o1 ^ ROR32(e1, 31) ^ ROR32(e1, 20);
+  e1 = te, o1 = to;
+  te = e2 ^ o2 ^ ROR32(e2, 3);
+  to = o2 ^ ROR32(e2, 1) ^ ROR32(o2, 3);
+  e2 = te, o2 = to;
+  te = e3 ^ ROR32(e3, 5) ^ ROR32(o3, 8);
+  to = o3 ^ ROR32(o3, 5) ^ ROR32(e3, 9);
+  e3 = te, o3 = to;
+  te = e4 ^ ROR32(o4, 3) ^ ROR32(o4, 20);
+  to = o4 ^ ROR32(e4, 4) ^ ROR32(e4, 21);
+  e4 = te, o4 = to;
+  s->x[0] = (uint64_t)o0 << 32 | e0;
+  s->x[1] = (uint64_t)o1 << 32 | e1;
+  s->x[2] = (uint64_t)o2 << 32 | e2;
+  s->x[3] = (uint64_t)o3 << 32 | e3;
+  s->x[4] = (uint64_t)o4 << 32 | e4;
+  printstate(" round output", s);
+}
+
+forceinline void PROUNDS(ascon_state_t* s, int nr) {
+  int i = START(nr);
+  do {
+    ROUND(s, RC(i));
+    i += INC;
+  } while (i != END);
+}
+
+#endif /* ROUND_BI32_H_ */
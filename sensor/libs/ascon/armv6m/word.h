@@ -1,6 +1,14 @@
 #ifndef WORD_H_
 #define WORD_H_
 
+#include "config.h"
+
+#if ASCON_BACKEND == ASCON_BACKEND_BI32
+
+#include "word_bi32.h"
+
+#else /* !ASCON_BACKEND_BI32 */
+
 #include <stdint.h>
 #include <string.h>
 
@@ -13,8 +21,13 @@ typedef union {
   uint8_t b[8];
 } word_t;
 
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+#define U64TOWORD(x) U64LE(x)
+#define WORDTOU64(x) U64LE(x)
+#else
 #define U64TOWORD(x) U64BIG(x)
 #define WORDTOU64(x) U64BIG(x)
+#endif
 #define LOAD(b, n) LOADBYTES(b, n)
 #define STORE(b, w, n) STOREBYTES(b, w, n)
 
@@ -32,15 +45,29 @@ forceinline int NOTZERO(uint64_t a, uint64_t b) {
   return ((((int)(result & 0xff) - 1) >> 8) & 1) - 1;
 }
 
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+
+forceinline uint64_t PAD(int i) { return 0x01ull << (8 * i); }
+
+forceinline uint64_t DSEP() { return 0x80ull << 56; }
+
+#else
+
 forceinline uint64_t PAD(int i) { return 0x80ull << (56 - 8 * i); }
 
 forceinline uint64_t DSEP() { return 0x01; }
 
+#endif
+
 forceinline uint64_t PRFS_MLEN(uint64_t len) { return len << 51; }
 
 forceinline uint64_t CLEAR(uint64_t w, int n) {
   /* undefined for n == 0 */
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+  uint64_t mask = ~0ull << (8 * n);
+#else
   uint64_t mask = ~0ull >> (8 * n);
+#endif
   return w & mask;
 }
 
@@ -60,4 +87,6 @@ forceinline void STOREBYTES(uint8_t* bytes, uint64_t w, int n) {
   memcpy(bytes, &x, n);
 }
 
+#endif /* ASCON_BACKEND_BI32 */
+
 #endif /* WORD_H_ */
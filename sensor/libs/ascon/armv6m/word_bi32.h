@@ -0,0 +1,135 @@
+#ifndef WORD_BI32_H_
+#define WORD_BI32_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bendian.h"
+#include "config.h"
+#include "forceinline.h"
+
+typedef union {
+  uint64_t x;
+  uint32_t w[2];
+  uint8_t b[8];
+} word_t;
+
+/* words are kept bit-interleaved: even bits in the low 32 bits and odd bits
+ * in the high 32 bits, so a 64-bit rotation becomes two 32-bit rotations */
+
+forceinline uint32_t ROR32(uint32_t x, int n) {
+  return x >> n | x << (-n & 31);
+}
+
+/* credit to Henry S. Warren, Hacker's Delight, Addison-Wesley, 2002 */
+forceinline uint32_t UNZIP32(uint32_t x) {
+  uint32_t t;
+  t = (x ^ (x >> 1)) & 0x22222222, x ^= t ^ (t << 1);
+  t = (x ^ (x >> 2)) & 0x0c0c0c0c, x ^= t ^ (t << 2);
+  t = (x ^ (x >> 4)) & 0x00f000f0, x ^= t ^ (t << 4);
+  t = (x ^ (x >> 8)) & 0x0000ff00, x ^= t ^ (t << 8);
+  return x;
+}
+
+forceinline uint32_t ZIP32(uint32_t x) {
+  uint32_t t;
+  t = (x ^ (x >> 8)) & 0x0000ff00, x ^= t ^ (t << 8);
+  t = (x ^ (x >> 4)) & 0x00f000f0, x ^= t ^ (t << 4);
+  t = (x ^ (x >> 2)) & 0x0c0c0c0c, x ^= t ^ (t << 2);
+  t = (x ^ (x >> 1)) & 0x22222222, x ^= t ^ (t << 1);
+  return x;
+}
+
+forceinline uint64_t TOBI(uint64_t in) {
+  uint32_t lo = UNZIP32((uint32_t)in);
+  uint32_t hi = UNZIP32((uint32_t)(in >> 32));
+  uint32_t e = (lo & 0x0000ffff) | (hi << 16);
+  uint32_t o = (lo >> 16) | (hi & 0xffff0000);
+  return (uint64_t)o << 32 | e;
+}
+
+forceinline uint64_t FROMBI(uint64_t in) {
+  uint32_t e = (uint32_t)in;
+  uint32_t o = (uint32_t)(in >> 32);
+  uint32_t lo = ZIP32((e & 0x0000ffff) | (o << 16));
+  uint32_t hi = ZIP32((e >> 16) | (o & 0xffff0000));
+  return (uint64_t)hi << 32 | lo;
+}
+
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+#define U64TOWORD(x) TOBI(U64LE(x))
+#define WORDTOU64(x) U64LE(FROMBI(x))
+#else
+#define U64TOWORD(x) TOBI(U64BIG(x))
+#define WORDTOU64(x) U64BIG(FROMBI(x))
+#endif
+#define LOAD(b, n) LOADBYTES(b, n)
+#define STORE(b, w, n) STOREBYTES(b, w, n)
+
+forceinline uint64_t ROR(uint64_t x, int n) {
+  uint32_t e = (uint32_t)x, o = (uint32_t)(x >> 32);
+  uint32_t re = (n % 2) ? ROR32(o, (n - 1) / 2) : ROR32(e, n / 2);
+  uint32_t ro = (n % 2) ? ROR32(e, (n + 1) / 2) : ROR32(o, n / 2);
+  return (uint64_t)ro << 32 | re;
+}
+
+forceinline uint64_t KEYROT(uint64_t lo2hi, uint64_t hi2lo) {
+  uint32_t e = (uint32_t)lo2hi << 16 | (uint32_t)hi2lo >> 16;
+  uint32_t o = (uint32_t)(lo2hi >> 32) << 16 | (uint32_t)(hi2lo >> 32) >> 16;
+  return (uint64_t)o << 32 | e;
+}
+
+forceinline int NOTZERO(uint64_t a, uint64_t b) {
+  uint64_t result = a | b;
+  result |= result >> 32;
+  result |= result >> 16;
+  result |= result >> 8;
+  return ((((int)(result & 0xff) - 1) >> 8) & 1) - 1;
+}
+
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+
+forceinline uint64_t PAD(int i) { return (uint64_t)0x01 << (4 * i); }
+
+forceinline uint64_t DSEP() { return (uint64_t)0x80000000 << 32; }
+
+#else
+
+forceinline uint64_t PAD(int i) {
+  return (uint64_t)((uint32_t)0x08 << (28 - 4 * i)) << 32;
+}
+
+forceinline uint64_t DSEP() { return 0x01; }
+
+#endif
+
+forceinline uint64_t PRFS_MLEN(uint64_t len) { return TOBI(len << 51); }
+
+forceinline uint64_t CLEAR(uint64_t w, int n) {
+  /* undefined for n == 0 */
+#if ASCON_VARIANT == ASCON_VARIANT_AEAD128
+  uint32_t mask = 0xffffffff << (4 * n);
+#else
+  uint32_t mask = 0x0fffffff >> (4 * n - 4);
+#endif
+  return w & ((uint64_t)mask << 32 | mask);
+}
+
+forceinline uint64_t MASK(int n) {
+  /* undefined for n == 0 */
+  uint32_t mask = 0xffffffff >> (32 - 4 * n);
+  return (uint64_t)mask << 32 | mask;
+}
+
+forceinline uint64_t LOADBYTES(const uint8_t* bytes, int n) {
+  uint64_t x = 0;
+  memcpy(&x, bytes, n);
+  return U64TOWORD(x);
+}
+
+forceinline void STOREBYTES(uint8_t* bytes, uint64_t w, int n) {
+  uint64_t x = WORDTOU64(w);
+  memcpy(bytes, &x, n);
+}
+
+#endif /* WORD_BI32_H_ */
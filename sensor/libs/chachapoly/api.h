@@ -0,0 +1,5 @@
+#define CRYPTO_KEYBYTES 32
+#define CRYPTO_NSECBYTES 0
+#define CRYPTO_NPUBBYTES 12
+#define CRYPTO_ABYTES 16
+#define CRYPTO_NOOVERLAP 1
@@ -0,0 +1,362 @@
+/*
+ *  ChaCha20-Poly1305 AEAD
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * [RFC8439] https://www.rfc-editor.org/rfc/rfc8439
+ *
+ * Poly1305 follows the 32-bit "donna" layout: the accumulator and r are five
+ * 26-bit limbs, so every product fits a 64-bit word and the reduction modulo
+ * 2^130 - 5 folds the carry out of the top limb back in times 5.
+ */
+
+#include "chachapoly.h"
+#include "api.h"
+#include "crypto_aead.h"
+
+#include <string.h>
+
+#define LOAD32_LE( b )                                  \
+    ( (uint32_t) (b)[0]         | (uint32_t) (b)[1] << 8 | \
+      (uint32_t) (b)[2] << 16   | (uint32_t) (b)[3] << 24 )
+
+#define STORE32_LE( b, v )                              \
+    do {                                                \
+        (b)[0] = (uint8_t) ( (v)       );               \
+        (b)[1] = (uint8_t) ( (v) >>  8 );               \
+        (b)[2] = (uint8_t) ( (v) >> 16 );               \
+        (b)[3] = (uint8_t) ( (v) >> 24 );               \
+    } while( 0 )
+
+#define ROTL32( x, n ) ( ( (x) << (n) ) | ( (x) >> ( 32 - (n) ) ) )
+
+#define QUARTERROUND( a, b, c, d )                      \
+    do {                                                \
+        a += b; d ^= a; d = ROTL32( d, 16 );            \
+        c += d; b ^= c; b = ROTL32( b, 12 );            \
+        a += b; d ^= a; d = ROTL32( d,  8 );            \
+        c += d; b ^= c; b = ROTL32( b,  7 );            \
+    } while( 0 )
+
+/* Volatile function pointer so the compiler keeps the wipe */
+static void * (* const volatile chachapoly_memset)( void *, int, size_t ) = memset;
+
+/*
+ * One 64 Byte keystream block, [RFC8439] 2.3
+ */
+static void chacha20_block( const uint32_t input[16], uint8_t out[64] )
+{
+    uint32_t x[16];
+    int i;
+
+    memcpy( x, input, sizeof( x ) );
+
+    for( i = 0; i < 10; i++ )
+    {
+        QUARTERROUND( x[0], x[4], x[ 8], x[12] );
+        QUARTERROUND( x[1], x[5], x[ 9], x[13] );
+        QUARTERROUND( x[2], x[6], x[10], x[14] );
+        QUARTERROUND( x[3], x[7], x[11], x[15] );
+        QUARTERROUND( x[0], x[5], x[10], x[15] );
+        QUARTERROUND( x[1], x[6], x[11], x[12] );
+        QUARTERROUND( x[2], x[7], x[ 8], x[13] );
+        QUARTERROUND( x[3], x[4], x[ 9], x[14] );
+    }
+
+    for( i = 0; i < 16; i++ )
+        STORE32_LE( out + 4 * i, x[i] + input[i] );
+
+    chachapoly_memset( x, 0, sizeof( x ) );
+}
+
+static void chacha20_setup( uint32_t state[16],
+                            const uint8_t key[CHACHAPOLY_KEYBYTES],
+                            uint32_t counter,
+                            const uint8_t nonce[CHACHAPOLY_NONCEBYTES] )
+{
+    int i;
+
+    /* "expand 32-byte k" */
+    state[0] = 0x61707865;
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+    for( i = 0; i < 8; i++ )
+        state[4 + i] = LOAD32_LE( key + 4 * i );
+    state[12] = counter;
+    for( i = 0; i < 3; i++ )
+        state[13 + i] = LOAD32_LE( nonce + 4 * i );
+}
+
+void chacha20_xor( const uint8_t key[CHACHAPOLY_KEYBYTES], uint32_t counter,
+                   const uint8_t nonce[CHACHAPOLY_NONCEBYTES],
+                   const uint8_t *input, uint8_t *output, size_t len )
+{
+    uint32_t state[16];
+    uint8_t ks[64];
+    size_t i, use_len;
+
+    chacha20_setup( state, key, counter, nonce );
+
+    while( len > 0 )
+    {
+        use_len = ( len < 64 ) ? len : 64;
+
+        chacha20_block( state, ks );
+        state[12]++;
+
+        for( i = 0; i < use_len; i++ )
+            output[i] = input[i] ^ ks[i];
+
+        len -= use_len;
+        input += use_len;
+        output += use_len;
+    }
+
+    chachapoly_memset( state, 0, sizeof( state ) );
+    chachapoly_memset( ks, 0, sizeof( ks ) );
+}
+
+void poly1305_init( chachapoly_poly1305 *st, const uint8_t key[32] )
+{
+    int i;
+
+    /* r with the bits of [RFC8439] 2.5 clamped */
+    st->r[0] = ( LOAD32_LE( key +  0 )      ) & 0x3ffffff;
+    st->r[1] = ( LOAD32_LE( key +  3 ) >> 2 ) & 0x3ffff03;
+    st->r[2] = ( LOAD32_LE( key +  6 ) >> 4 ) & 0x3ffc0ff;
+    st->r[3] = ( LOAD32_LE( key +  9 ) >> 6 ) & 0x3f03fff;
+    st->r[4] = ( LOAD32_LE( key + 12 ) >> 8 ) & 0x00fffff;
+
+    for( i = 0; i < 5; i++ )
+        st->h[i] = 0;
+
+    for( i = 0; i < 4; i++ )
+        st->pad[i] = LOAD32_LE( key + 16 + 4 * i );
+}
+
+/*
+ * h = (h + m) * r mod 2^130 - 5 for one 16 Byte block, with the 2^128 bit
+ * of a full block
+ */
+static void poly1305_block( chachapoly_poly1305 *st, const uint8_t m[16] )
+{
+    const uint32_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2];
+    const uint32_t r3 = st->r[3], r4 = st->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2];
+    uint32_t h3 = st->h[3], h4 = st->h[4];
+    uint64_t d0, d1, d2, d3, d4;
+    uint32_t c;
+
+    h0 += ( LOAD32_LE( m +  0 )      ) & 0x3ffffff;
+    h1 += ( LOAD32_LE( m +  3 ) >> 2 ) & 0x3ffffff;
+    h2 += ( LOAD32_LE( m +  6 ) >> 4 ) & 0x3ffffff;
+    h3 += ( LOAD32_LE( m +  9 ) >> 6 ) & 0x3ffffff;
+    h4 += ( LOAD32_LE( m + 12 ) >> 8 ) | ( 1 << 24 );
+
+    d0 = (uint64_t) h0 * r0 + (uint64_t) h1 * s4 + (uint64_t) h2 * s3 +
+         (uint64_t) h3 * s2 + (uint64_t) h4 * s1;
+    d1 = (uint64_t) h0 * r1 + (uint64_t) h1 * r0 + (uint64_t) h2 * s4 +
+         (uint64_t) h3 * s3 + (uint64_t) h4 * s2;
+    d2 = (uint64_t) h0 * r2 + (uint64_t) h1 * r1 + (uint64_t) h2 * r0 +
+         (uint64_t) h3 * s4 + (uint64_t) h4 * s3;
+    d3 = (uint64_t) h0 * r3 + (uint64_t) h1 * r2 + (uint64_t) h2 * r1 +
+         (uint64_t) h3 * r0 + (uint64_t) h4 * s4;
+    d4 = (uint64_t) h0 * r4 + (uint64_t) h1 * r3 + (uint64_t) h2 * r2 +
+         (uint64_t) h3 * r1 + (uint64_t) h4 * r0;
+
+    /* partial reduction, h stays below 2^131 */
+    c = (uint32_t) ( d0 >> 26 ); h0 = (uint32_t) d0 & 0x3ffffff;
+    d1 += c; c = (uint32_t) ( d1 >> 26 ); h1 = (uint32_t) d1 & 0x3ffffff;
+    d2 += c; c = (uint32_t) ( d2 >> 26 ); h2 = (uint32_t) d2 & 0x3ffffff;
+    d3 += c; c = (uint32_t) ( d3 >> 26 ); h3 = (uint32_t) d3 & 0x3ffffff;
+    d4 += c; c = (uint32_t) ( d4 >> 26 ); h4 = (uint32_t) d4 & 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    st->h[0] = h0;
+    st->h[1] = h1;
+    st->h[2] = h2;
+    st->h[3] = h3;
+    st->h[4] = h4;
+}
+
+void poly1305_update_padded( chachapoly_poly1305 *st,
+                             const uint8_t *m, size_t len )
+{
+    uint8_t block[16];
+
+    for( ; len >= 16; len -= 16, m += 16 )
+        poly1305_block( st, m );
+
+    if( len > 0 )
+    {
+        memset( block, 0, sizeof( block ) );
+        memcpy( block, m, len );
+        poly1305_block( st, block );
+    }
+}
+
+void poly1305_finish( chachapoly_poly1305 *st, uint8_t tag[16] )
+{
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2];
+    uint32_t h3 = st->h[3], h4 = st->h[4];
+    uint32_t g0, g1, g2, g3, g4, c, mask;
+    uint64_t f;
+
+    /* full carry */
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    /* g = h + 5 - 2^130, taken instead of h when it does not borrow */
+    g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    g4 = h4 + c - ( 1 << 26 );
+
+    mask = ( g4 >> 31 ) - 1;
+    h0 = ( h0 & ~mask ) | ( g0 & mask );
+    h1 = ( h1 & ~mask ) | ( g1 & mask );
+    h2 = ( h2 & ~mask ) | ( g2 & mask );
+    h3 = ( h3 & ~mask ) | ( g3 & mask );
+    h4 = ( h4 & ~mask ) | ( g4 & mask );
+
+    /* h mod 2^128 in 32-bit words, plus s */
+    h0 = ( h0       ) | ( h1 << 26 );
+    h1 = ( h1 >>  6 ) | ( h2 << 20 );
+    h2 = ( h2 >> 12 ) | ( h3 << 14 );
+    h3 = ( h3 >> 18 ) | ( h4 <<  8 );
+
+    f = (uint64_t) h0 + st->pad[0];             STORE32_LE( tag +  0, (uint32_t) f );
+    f = (uint64_t) h1 + st->pad[1] + ( f >> 32 ); STORE32_LE( tag +  4, (uint32_t) f );
+    f = (uint64_t) h2 + st->pad[2] + ( f >> 32 ); STORE32_LE( tag +  8, (uint32_t) f );
+    f = (uint64_t) h3 + st->pad[3] + ( f >> 32 ); STORE32_LE( tag + 12, (uint32_t) f );
+
+    chachapoly_memset( st, 0, sizeof( chachapoly_poly1305 ) );
+}
+
+/*
+ * Tag of [RFC8439] 2.8: Poly1305 with the first 32 Bytes of keystream block 0
+ * over AD || pad || ciphertext || pad || len(AD) || len(ciphertext)
+ */
+static void chachapoly_tag( uint8_t tag[16], const uint8_t *c, size_t clen,
+                            const uint8_t *ad, size_t adlen,
+                            const uint8_t nonce[CHACHAPOLY_NONCEBYTES],
+                            const uint8_t key[CHACHAPOLY_KEYBYTES] )
+{
+    chachapoly_poly1305 st;
+    uint32_t state[16];
+    uint8_t block[64];
+
+    chacha20_setup( state, key, 0, nonce );
+    chacha20_block( state, block );
+    poly1305_init( &st, block );
+
+    poly1305_update_padded( &st, ad, adlen );
+    poly1305_update_padded( &st, c, clen );
+
+    STORE32_LE( block +  0, (uint32_t) adlen );
+    STORE32_LE( block +  4, (uint32_t) ( (uint64_t) adlen >> 32 ) );
+    STORE32_LE( block +  8, (uint32_t) clen );
+    STORE32_LE( block + 12, (uint32_t) ( (uint64_t) clen >> 32 ) );
+    poly1305_block( &st, block );
+
+    poly1305_finish( &st, tag );
+
+    chachapoly_memset( state, 0, sizeof( state ) );
+    chachapoly_memset( block, 0, sizeof( block ) );
+}
+
+void chachapoly_seal( uint8_t *c, const uint8_t *m, size_t mlen,
+                      const uint8_t *ad, size_t adlen,
+                      const uint8_t nonce[CHACHAPOLY_NONCEBYTES],
+                      const uint8_t key[CHACHAPOLY_KEYBYTES] )
+{
+    chacha20_xor( key, 1, nonce, m, c, mlen );
+    chachapoly_tag( c + mlen, c, mlen, ad, adlen, nonce, key );
+}
+
+int chachapoly_open( uint8_t *m, const uint8_t *c, size_t clen,
+                     const uint8_t *ad, size_t adlen,
+                     const uint8_t nonce[CHACHAPOLY_NONCEBYTES],
+                     const uint8_t key[CHACHAPOLY_KEYBYTES] )
+{
+    uint8_t tag[CHACHAPOLY_TAGBYTES];
+    uint8_t diff = 0;
+    size_t i;
+
+    if( clen < CHACHAPOLY_TAGBYTES )
+        return( -1 );
+    clen -= CHACHAPOLY_TAGBYTES;
+
+    chachapoly_tag( tag, c, clen, ad, adlen, nonce, key );
+
+    /* Check tag in "constant-time" */
+    for( i = 0; i < CHACHAPOLY_TAGBYTES; i++ )
+        diff |= tag[i] ^ c[clen + i];
+
+    if( diff != 0 )
+        return( -1 );
+
+    chacha20_xor( key, 1, nonce, c, m, clen );
+
+    return( 0 );
+}
+
+/*
+ * Encrypt function for NIST API
+ */
+int crypto_aead_encrypt(
+      unsigned char *c,unsigned long long *clen,
+      const unsigned char *m,unsigned long long mlen,
+      const unsigned char *ad,unsigned long long adlen,
+      const unsigned char *nsec,
+      const unsigned char *npub,
+      const unsigned char *k
+      )
+{
+  (void) nsec;
+
+  chachapoly_seal( c, m, (size_t) mlen, ad, (size_t) adlen, npub, k );
+  *clen = mlen + CRYPTO_ABYTES;
+
+  return 0;
+}
+
+int crypto_aead_decrypt(
+  unsigned char *m, unsigned long long *mlen,
+  unsigned char *nsec,
+  const unsigned char *c, unsigned long long clen,
+  const unsigned char *ad, unsigned long long adlen,
+  const unsigned char *npub,
+  const unsigned char *k
+)
+{
+  (void) nsec;
+
+  if( clen < CRYPTO_ABYTES )
+    return -1;
+
+  *mlen = clen - CRYPTO_ABYTES;
+  return chachapoly_open( m, c, (size_t) clen, ad, (size_t) adlen, npub, k );
+}
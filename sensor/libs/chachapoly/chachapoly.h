@@ -0,0 +1,122 @@
+/**
+ * \file chachapoly.h
+ *
+ * \brief   ChaCha20-Poly1305 AEAD of RFC 8439 (256-bit key, 96-bit nonce,
+ *          128-bit tag) in portable 32-bit C
+ *
+ *          ChaCha20 only adds, rotates and XORs 32-bit words and Poly1305
+ *          uses 26-bit limbs, so neither needs tables or AES hardware and
+ *          both run in constant time on the Cortex-M0+.
+ *          crypto_aead_encrypt() and crypto_aead_decrypt() of crypto_aead.h
+ *          seal and open frames in the layout of the other engines,
+ *          ciphertext followed by the tag.
+ */
+#ifndef CHACHAPOLY_H
+#define CHACHAPOLY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHACHAPOLY_KEYBYTES     32
+#define CHACHAPOLY_NONCEBYTES   12
+#define CHACHAPOLY_TAGBYTES     16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          ChaCha20 of RFC 8439 2.4, output = input XOR keystream.
+ *
+ * \param key      The 32 Byte key.
+ * \param counter  The block counter of the first block.
+ * \param nonce    The 12 Byte nonce.
+ * \param input    The input, may be the same buffer as \p output.
+ * \param output   The output.
+ * \param len      The length of \p input.
+ */
+void chacha20_xor( const uint8_t key[CHACHAPOLY_KEYBYTES], uint32_t counter,
+                   const uint8_t nonce[CHACHAPOLY_NONCEBYTES],
+                   const uint8_t *input, uint8_t *output, size_t len );
+
+/**
+ * \brief          Poly1305 state, the key r and s and the accumulator h in
+ *                 26-bit limbs.
+ */
+typedef struct chachapoly_poly1305
+{
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+}
+chachapoly_poly1305;
+
+/**
+ * \brief          Starts Poly1305 with a one-time key.
+ *
+ * \param st       The state.
+ * \param key      The 32 Byte one-time key, r followed by s.
+ */
+void poly1305_init( chachapoly_poly1305 *st, const uint8_t key[32] );
+
+/**
+ * \brief          Adds data to Poly1305, zero padded to a multiple of 16
+ *                 Bytes as the AEAD construction of RFC 8439 2.8 does.
+ *
+ * \param st       The state.
+ * \param m        The data.
+ * \param len      The length of \p m.
+ */
+void poly1305_update_padded( chachapoly_poly1305 *st,
+                             const uint8_t *m, size_t len );
+
+/**
+ * \brief          Computes the tag and wipes the state.
+ *
+ * \param st       The state.
+ * \param tag      The 16 Byte tag.
+ */
+void poly1305_finish( chachapoly_poly1305 *st, uint8_t tag[16] );
+
+/**
+ * \brief          Encrypts one message, \p c holds the ciphertext followed
+ *                 by the 16 Byte tag.
+ *
+ * \param c        The buffer for ciphertext and tag, \p mlen + 16 Bytes.
+ * \param m        The plaintext.
+ * \param mlen     The length of the plaintext.
+ * \param ad       The additional data, or \c NULL if \p adlen is \c 0.
+ * \param adlen    The length of the additional data.
+ * \param nonce    The 12 Byte nonce.
+ * \param key      The 32 Byte key.
+ */
+void chachapoly_seal( uint8_t *c, const uint8_t *m, size_t mlen,
+                      const uint8_t *ad, size_t adlen,
+                      const uint8_t nonce[CHACHAPOLY_NONCEBYTES],
+                      const uint8_t key[CHACHAPOLY_KEYBYTES] );
+
+/**
+ * \brief          Verifies and decrypts one message of chachapoly_seal().
+ *                 The tag is checked before anything is decrypted.
+ *
+ * \param m        The buffer for the plaintext, \p clen - 16 Bytes.
+ * \param c        The ciphertext followed by the tag.
+ * \param clen     The length of ciphertext and tag, at least 16.
+ * \param ad       The additional data, or \c NULL if \p adlen is \c 0.
+ * \param adlen    The length of the additional data.
+ * \param nonce    The 12 Byte nonce.
+ * \param key      The 32 Byte key.
+ *
+ * \return         \c 0 if the tag matches, \c -1 otherwise (\p m is not
+ *                 written then).
+ */
+int chachapoly_open( uint8_t *m, const uint8_t *c, size_t clen,
+                     const uint8_t *ad, size_t adlen,
+                     const uint8_t nonce[CHACHAPOLY_NONCEBYTES],
+                     const uint8_t key[CHACHAPOLY_KEYBYTES] );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* chachapoly.h */
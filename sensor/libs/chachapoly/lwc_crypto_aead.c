@@ -0,0 +1,14 @@
+#include "lwc_crypto_aead.h"
+#include "api.h"
+
+
+aead_ctx lwc_aead_cipher = {
+	"chacha20-poly1305",
+	"chachapoly-ref",
+	CRYPTO_KEYBYTES,
+	CRYPTO_NPUBBYTES,
+	CRYPTO_ABYTES,
+	crypto_aead_encrypt,
+	crypto_aead_decrypt
+};
+
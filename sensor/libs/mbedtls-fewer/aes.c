@@ -30,9 +30,25 @@
 #include <string.h>
 
 #include "aes.h"
+#include "aesni.h"
 
-//#define MBEDTLS_AES_ROM_TABLES
+/*
+ * Table layout, selected by the build:
+ *  - MBEDTLS_AES_ROM_TABLES: S-boxes and round tables are const data, which
+ *    the linker keeps in flash (XIP on the Pico). Otherwise aes_gen_tables()
+ *    computes them into RAM at the first key setup.
+ *  - MBEDTLS_AES_FULL_TABLES: four forward and four reverse round tables
+ *    (8 KB) instead of one of each (2 KB) rotated at every lookup.
+ */
+#if !defined(MBEDTLS_AES_FULL_TABLES)
 #define MBEDTLS_AES_FEWER_TABLES
+#endif
+
+/*
+ * MBEDTLS_AES_FIXSLICED replaces the table based AES-128 encryption with the
+ * constant-time bitsliced one of aes_fixsliced.c and leaves out the tables
+ * and the decryption, which GCM does not need.
+ */
 
 /* Parameter validation macros based on platform_util.h */
 #define AES_VALIDATE_RET( cond )    \
@@ -63,6 +79,8 @@
 }
 #endif
 
+#if !defined(MBEDTLS_AES_FIXSLICED)
+
 #if defined(MBEDTLS_AES_ROM_TABLES)
 /*
  * Forward S-box
@@ -488,6 +506,8 @@ static void aes_gen_tables( void )
 
 #endif /* MBEDTLS_AES_FEWER_TABLES */
 
+#endif /* !MBEDTLS_AES_FIXSLICED */
+
 void nbedtls_aes_init( nbedtls_aes_context *ctx )
 {
     AES_VALIDATE( ctx != NULL );
@@ -503,6 +523,7 @@ void nbedtls_aes_free( nbedtls_aes_context *ctx )
     nbedtls_platform_zeroize( ctx, sizeof( nbedtls_aes_context ) );
 }
 
+#if !defined(MBEDTLS_AES_FIXSLICED)
 /*
  * AES key schedule (encryption)
  */
@@ -820,6 +841,58 @@ int nbedtls_internal_aes_decrypt( nbedtls_aes_context *ctx,
     return( 0 );
 }
 
+/*
+ * Two AES-ECB block encryptions
+ */
+int nbedtls_aes_crypt_ecb2( nbedtls_aes_context *ctx,
+                            const unsigned char input0[16],
+                            const unsigned char input1[16],
+                            unsigned char output0[16],
+                            unsigned char output1[16] )
+{
+    int ret;
+
+    AES_VALIDATE_RET( ctx != NULL );
+
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+    if( nbedtls_aesni_has_support( MBEDTLS_AESNI_AES ) )
+    {
+        nbedtls_aesni_crypt_ecb( ctx, MBEDTLS_AES_ENCRYPT, input0, output0 );
+        return( nbedtls_aesni_crypt_ecb( ctx, MBEDTLS_AES_ENCRYPT, input1, output1 ) );
+    }
+#endif
+
+    if( ( ret = nbedtls_internal_aes_encrypt( ctx, input0, output0 ) ) != 0 )
+        return( ret );
+
+    return( nbedtls_internal_aes_encrypt( ctx, input1, output1 ) );
+}
+
+#else /* !MBEDTLS_AES_FIXSLICED */
+
+int nbedtls_aes_setkey_dec( nbedtls_aes_context *ctx, const unsigned char *key,
+                    unsigned int keybits )
+{
+    (void) ctx;
+    (void) key;
+    (void) keybits;
+
+    return( MBEDTLS_ERR_AES_FEATURE_UNAVAILABLE );
+}
+
+int nbedtls_internal_aes_decrypt( nbedtls_aes_context *ctx,
+                                  const unsigned char input[16],
+                                  unsigned char output[16] )
+{
+    (void) ctx;
+    (void) input;
+    (void) output;
+
+    return( MBEDTLS_ERR_AES_FEATURE_UNAVAILABLE );
+}
+
+#endif /* !MBEDTLS_AES_FIXSLICED */
+
 /*
  * AES-ECB block encryption/decryption
  */
@@ -834,6 +907,11 @@ int nbedtls_aes_crypt_ecb( nbedtls_aes_context *ctx,
     AES_VALIDATE_RET( mode == MBEDTLS_AES_ENCRYPT ||
                       mode == MBEDTLS_AES_DECRYPT );
 
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+    if( nbedtls_aesni_has_support( MBEDTLS_AESNI_AES ) )
+        return( nbedtls_aesni_crypt_ecb( ctx, mode, input, output ) );
+#endif
+
     if( mode == MBEDTLS_AES_ENCRYPT )
         return( nbedtls_internal_aes_encrypt( ctx, input, output ) );
     else
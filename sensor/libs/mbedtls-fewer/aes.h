@@ -55,6 +55,8 @@
 /* Error codes in range 0x0021-0x0025 */
 #define MBEDTLS_ERR_AES_BAD_INPUT_DATA                    -0x0021  /**< Invalid input data. */
 
+#define MBEDTLS_ERR_AES_FEATURE_UNAVAILABLE               -0x0023  /**< Feature not available. For example, decryption with MBEDTLS_AES_FIXSLICED. */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -69,6 +71,9 @@ typedef struct nbedtls_aes_context
 {
     int nr;                     /*!< The number of rounds. */
     uint32_t *rk;               /*!< AES round keys. */
+#if defined(MBEDTLS_AES_FIXSLICED)
+    uint32_t buf[88];           /*!< 11 bitsliced round keys of 8 words. */
+#else
     uint32_t buf[68];           /*!< Unaligned data buffer. This buffer can
                                      hold 32 extra Bytes, which can be used for
                                      one of the following purposes:
@@ -77,6 +82,7 @@ typedef struct nbedtls_aes_context
                                      <li>Simplifying key expansion in the 256-bit
                                          case by generating an extra round key.
                                          </li></ul> */
+#endif
 }
 nbedtls_aes_context;
 
@@ -163,6 +169,28 @@ int nbedtls_aes_crypt_ecb( nbedtls_aes_context *ctx,
                     const unsigned char input[16],
                     unsigned char output[16] );
 
+/**
+ * \brief          This function encrypts two independent blocks, for example
+ *                 two CTR counter blocks.
+ *
+ *                 With \c MBEDTLS_AES_FIXSLICED both blocks go through one
+ *                 bitsliced pass and cost about as much as one, otherwise
+ *                 this is two calls of the table based encryption.
+ *
+ * \param ctx      The AES context, bound to an encryption key.
+ * \param input0   The first plaintext block.
+ * \param input1   The second plaintext block.
+ * \param output0  The first ciphertext block.
+ * \param output1  The second ciphertext block.
+ *
+ * \return         \c 0 on success.
+ */
+int nbedtls_aes_crypt_ecb2( nbedtls_aes_context *ctx,
+                            const unsigned char input0[16],
+                            const unsigned char input1[16],
+                            unsigned char output0[16],
+                            unsigned char output1[16] );
+
 /**
  * \brief           Internal AES block encryption function. This is only
  *                  exposed to allow overriding it using
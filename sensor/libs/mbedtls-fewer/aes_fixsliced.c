@@ -0,0 +1,477 @@
+/*
+ *  Fixsliced AES-128 encryption, constant time
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * A. Adomnicai, T. Peyrin, "Fixslicing AES-like Ciphers", TCHES 2021(1).
+ * S-box: J. Boyar, R. Peralta, "A depth-16 circuit for the AES S-box", 2011.
+ *
+ * Two blocks are processed at once in 8 words of 32 bits. Word i holds bit i
+ * of every state byte, byte (row r, column c) of block b sits at bit
+ * 8 * r + 2 * c + b. The S-box is a boolean circuit and there are no table
+ * lookups or secret dependent branches.
+ *
+ * ShiftRows is never computed. After round j the state is SR^-(j mod 4) of
+ * the real state, so round j uses MixColumns conjugated by SR^(j mod 4) and a
+ * round key with SR^-(j mod 4) already applied, and the output is fixed with
+ * SR^2 after the 10th round.
+ */
+
+#include "platform_util.h"
+
+#include <string.h>
+
+#include "aes.h"
+
+#if defined(MBEDTLS_AES_FIXSLICED)
+
+/* Parameter validation macros based on platform_util.h */
+#define AES_VALIDATE_RET( cond )    \
+    MBEDTLS_INTERNAL_VALIDATE_RET( cond, MBEDTLS_ERR_AES_BAD_INPUT_DATA )
+
+#define AES_FS_WORDS    8               /* words per bitsliced state */
+#define AES_FS_ROUNDS   10
+
+/*
+ * 32-bit integer manipulation macros (little endian)
+ */
+#ifndef GET_UINT32_LE
+#define GET_UINT32_LE(n,b,i)                            \
+{                                                       \
+    (n) = ( (uint32_t) (b)[(i)    ]       )             \
+        | ( (uint32_t) (b)[(i) + 1] <<  8 )             \
+        | ( (uint32_t) (b)[(i) + 2] << 16 )             \
+        | ( (uint32_t) (b)[(i) + 3] << 24 );            \
+}
+#endif
+
+#ifndef PUT_UINT32_LE
+#define PUT_UINT32_LE(n,b,i)                                    \
+{                                                               \
+    (b)[(i)    ] = (unsigned char) ( ( (n)       ) & 0xFF );    \
+    (b)[(i) + 1] = (unsigned char) ( ( (n) >>  8 ) & 0xFF );    \
+    (b)[(i) + 2] = (unsigned char) ( ( (n) >> 16 ) & 0xFF );    \
+    (b)[(i) + 3] = (unsigned char) ( ( (n) >> 24 ) & 0xFF );    \
+}
+#endif
+
+/* Exchanges the bits of a selected by mask << n with the bits of b
+ * selected by mask */
+#define SWAPMOVE(a,b,mask,n)                            \
+    do                                                  \
+    {                                                   \
+        uint32_t t_ = ( ( (a) >> (n) ) ^ (b) ) & (mask); \
+        (b) ^= t_;                                      \
+        (a) ^= t_ << (n);                               \
+    } while( 0 )
+
+#define ROR32(x,n)  ( ( (x) >> (n) ) | ( (x) << ( 32 - (n) ) ) )
+
+/* Rotates every byte of x right by n bits, 0 <= n < 8 */
+static inline uint32_t byte_ror( uint32_t x, unsigned int n )
+{
+    uint32_t mask = ( 0xFFu >> n ) * 0x01010101u;
+
+    return( ( ( x >> n ) & mask ) | ( ( x << ( 8 - n ) ) & ~mask ) );
+}
+
+/*
+ * Word 2 * c + b starts as column c of block b, three SWAPMOVE layers then
+ * exchange the word index with the bit index inside each byte
+ */
+static void aes_fs_pack( uint32_t s[AES_FS_WORDS],
+                         const unsigned char in0[16],
+                         const unsigned char in1[16] )
+{
+    int c;
+
+    for( c = 0; c < 4; c++ )
+    {
+        GET_UINT32_LE( s[2 * c], in0, 4 * c );
+        GET_UINT32_LE( s[2 * c + 1], in1, 4 * c );
+    }
+
+    SWAPMOVE( s[0], s[1], 0x55555555, 1 );
+    SWAPMOVE( s[2], s[3], 0x55555555, 1 );
+    SWAPMOVE( s[4], s[5], 0x55555555, 1 );
+    SWAPMOVE( s[6], s[7], 0x55555555, 1 );
+
+    SWAPMOVE( s[0], s[2], 0x33333333, 2 );
+    SWAPMOVE( s[1], s[3], 0x33333333, 2 );
+    SWAPMOVE( s[4], s[6], 0x33333333, 2 );
+    SWAPMOVE( s[5], s[7], 0x33333333, 2 );
+
+    SWAPMOVE( s[0], s[4], 0x0F0F0F0F, 4 );
+    SWAPMOVE( s[1], s[5], 0x0F0F0F0F, 4 );
+    SWAPMOVE( s[2], s[6], 0x0F0F0F0F, 4 );
+    SWAPMOVE( s[3], s[7], 0x0F0F0F0F, 4 );
+}
+
+static void aes_fs_unpack( unsigned char out0[16], unsigned char out1[16],
+                           uint32_t s[AES_FS_WORDS] )
+{
+    int c;
+
+    SWAPMOVE( s[0], s[4], 0x0F0F0F0F, 4 );
+    SWAPMOVE( s[1], s[5], 0x0F0F0F0F, 4 );
+    SWAPMOVE( s[2], s[6], 0x0F0F0F0F, 4 );
+    SWAPMOVE( s[3], s[7], 0x0F0F0F0F, 4 );
+
+    SWAPMOVE( s[0], s[2], 0x33333333, 2 );
+    SWAPMOVE( s[1], s[3], 0x33333333, 2 );
+    SWAPMOVE( s[4], s[6], 0x33333333, 2 );
+    SWAPMOVE( s[5], s[7], 0x33333333, 2 );
+
+    SWAPMOVE( s[0], s[1], 0x55555555, 1 );
+    SWAPMOVE( s[2], s[3], 0x55555555, 1 );
+    SWAPMOVE( s[4], s[5], 0x55555555, 1 );
+    SWAPMOVE( s[6], s[7], 0x55555555, 1 );
+
+    for( c = 0; c < 4; c++ )
+    {
+        PUT_UINT32_LE( s[2 * c], out0, 4 * c );
+        PUT_UINT32_LE( s[2 * c + 1], out1, 4 * c );
+    }
+}
+
+/*
+ * SubBytes on all 32 bytes, Boyar-Peralta circuit (32 AND, 83 XOR, 4 NOT).
+ * U0 and S0 are the most significant bits.
+ */
+static void aes_fs_sbox( uint32_t s[AES_FS_WORDS] )
+{
+    uint32_t U0 = s[7], U1 = s[6], U2 = s[5], U3 = s[4];
+    uint32_t U4 = s[3], U5 = s[2], U6 = s[1], U7 = s[0];
+    uint32_t T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14;
+    uint32_t T15, T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26, T27;
+    uint32_t M1, M2, M3, M4, M5, M6, M7, M8, M9, M10, M11, M12, M13, M14;
+    uint32_t M15, M16, M17, M18, M19, M20, M21, M22, M23, M24, M25, M26, M27;
+    uint32_t M28, M29, M30, M31, M32, M33, M34, M35, M36, M37, M38, M39, M40;
+    uint32_t M41, M42, M43, M44, M45, M46, M47, M48, M49, M50, M51, M52, M53;
+    uint32_t M54, M55, M56, M57, M58, M59, M60, M61, M62, M63;
+    uint32_t L0, L1, L2, L3, L4, L5, L6, L7, L8, L9, L10, L11, L12, L13, L14;
+    uint32_t L15, L16, L17, L18, L19, L20, L21, L22, L23, L24, L25, L26, L27;
+    uint32_t L28, L29;
+
+    /* top linear layer */
+    T1 = U0 ^ U3;
+    T2 = U0 ^ U5;
+    T3 = U0 ^ U6;
+    T4 = U3 ^ U5;
+    T5 = U4 ^ U6;
+    T6 = T1 ^ T5;
+    T7 = U1 ^ U2;
+    T8 = U7 ^ T6;
+    T9 = U7 ^ T7;
+    T10 = T6 ^ T7;
+    T11 = U1 ^ U5;
+    T12 = U2 ^ U5;
+    T13 = T3 ^ T4;
+    T14 = T6 ^ T11;
+    T15 = T5 ^ T11;
+    T16 = T5 ^ T12;
+    T17 = T9 ^ T16;
+    T18 = U3 ^ U7;
+    T19 = T7 ^ T18;
+    T20 = T1 ^ T19;
+    T21 = U6 ^ U7;
+    T22 = T7 ^ T21;
+    T23 = T2 ^ T22;
+    T24 = T2 ^ T10;
+    T25 = T20 ^ T17;
+    T26 = T3 ^ T16;
+    T27 = T1 ^ T12;
+
+    /* shared nonlinear middle: inversion in GF(2^4)^2 */
+    M1 = T13 & T6;
+    M2 = T23 & T8;
+    M3 = T14 ^ M1;
+    M4 = T19 & U7;
+    M5 = M4 ^ M1;
+    M6 = T3 & T16;
+    M7 = T22 & T9;
+    M8 = T26 ^ M6;
+    M9 = T20 & T17;
+    M10 = M9 ^ M6;
+    M11 = T1 & T15;
+    M12 = T4 & T27;
+    M13 = M12 ^ M11;
+    M14 = T2 & T10;
+    M15 = M14 ^ M11;
+    M16 = M3 ^ M2;
+    M17 = M5 ^ T24;
+    M18 = M8 ^ M7;
+    M19 = M10 ^ M15;
+    M20 = M16 ^ M13;
+    M21 = M17 ^ M15;
+    M22 = M18 ^ M13;
+    M23 = M19 ^ T25;
+    M24 = M22 ^ M23;
+    M25 = M22 & M20;
+    M26 = M21 ^ M25;
+    M27 = M20 ^ M21;
+    M28 = M23 ^ M25;
+    M29 = M28 & M27;
+    M30 = M26 & M24;
+    M31 = M20 & M23;
+    M32 = M27 & M31;
+    M33 = M27 ^ M25;
+    M34 = M21 & M22;
+    M35 = M24 & M34;
+    M36 = M24 ^ M25;
+    M37 = M21 ^ M29;
+    M38 = M32 ^ M33;
+    M39 = M23 ^ M30;
+    M40 = M35 ^ M36;
+    M41 = M38 ^ M40;
+    M42 = M37 ^ M39;
+    M43 = M37 ^ M38;
+    M44 = M39 ^ M40;
+    M45 = M42 ^ M41;
+    M46 = M44 & T6;
+    M47 = M40 & T8;
+    M48 = M39 & U7;
+    M49 = M43 & T16;
+    M50 = M38 & T9;
+    M51 = M37 & T17;
+    M52 = M42 & T15;
+    M53 = M45 & T27;
+    M54 = M41 & T10;
+    M55 = M44 & T13;
+    M56 = M40 & T23;
+    M57 = M39 & T19;
+    M58 = M43 & T3;
+    M59 = M38 & T22;
+    M60 = M37 & T20;
+    M61 = M42 & T1;
+    M62 = M45 & T4;
+    M63 = M41 & T2;
+
+    /* bottom linear layer, includes the affine constant 0x63 */
+    L0 = M61 ^ M62;
+    L1 = M50 ^ M56;
+    L2 = M46 ^ M48;
+    L3 = M47 ^ M55;
+    L4 = M54 ^ M58;
+    L5 = M49 ^ M61;
+    L6 = M62 ^ L5;
+    L7 = M46 ^ L3;
+    L8 = M51 ^ M59;
+    L9 = M52 ^ M53;
+    L10 = M53 ^ L4;
+    L11 = M60 ^ L2;
+    L12 = M48 ^ M51;
+    L13 = M50 ^ L0;
+    L14 = M52 ^ M61;
+    L15 = M55 ^ L1;
+    L16 = M56 ^ L0;
+    L17 = M57 ^ L1;
+    L18 = M58 ^ L8;
+    L19 = M63 ^ L4;
+    L20 = L0 ^ L1;
+    L21 = L1 ^ L7;
+    L22 = L3 ^ L12;
+    L23 = L18 ^ L2;
+    L24 = L15 ^ L9;
+    L25 = L6 ^ L10;
+    L26 = L7 ^ L9;
+    L27 = L8 ^ L10;
+    L28 = L11 ^ L14;
+    L29 = L11 ^ L17;
+
+    s[7] = L6 ^ L24;
+    s[6] = ~( L16 ^ L26 );
+    s[5] = ~( L19 ^ L28 );
+    s[4] = L6 ^ L21;
+    s[3] = L20 ^ L22;
+    s[2] = L25 ^ L29;
+    s[1] = ~( L13 ^ L27 );
+    s[0] = ~( L6 ^ L23 );
+}
+
+/*
+ * MixColumns conjugated by SR^q: byte (r, c) takes the bytes (r + d, c + q * d)
+ * of the fixsliced state instead of (r + d, c). A1 and A2 fetch d = 1 and
+ * d = 2, and out = 2 * (a ^ A1(a)) ^ A1(a) ^ A2(a ^ A1(a)).
+ */
+static inline void aes_fs_mixcolumns( uint32_t s[AES_FS_WORDS], unsigned int q )
+{
+    uint32_t a1[AES_FS_WORDS], t[AES_FS_WORDS];
+    int i;
+
+    for( i = 0; i < AES_FS_WORDS; i++ )
+    {
+        a1[i] = byte_ror( ROR32( s[i], 8 ), ( 2 * q ) & 7 );
+        t[i] = s[i] ^ a1[i];
+        s[i] = a1[i] ^ byte_ror( ROR32( t[i], 16 ), ( 4 * q ) & 7 );
+    }
+
+    /* multiplication of t by x in GF(2^8) */
+    s[0] ^= t[7];
+    s[1] ^= t[0] ^ t[7];
+    s[2] ^= t[1];
+    s[3] ^= t[2] ^ t[7];
+    s[4] ^= t[3] ^ t[7];
+    s[5] ^= t[4];
+    s[6] ^= t[5];
+    s[7] ^= t[6];
+}
+
+static inline void aes_fs_ark( uint32_t s[AES_FS_WORDS], const uint32_t *rk )
+{
+    int i;
+
+    for( i = 0; i < AES_FS_WORDS; i++ )
+        s[i] ^= rk[i];
+}
+
+/* SubWord of the key schedule with the same constant-time S-box */
+static uint32_t aes_fs_subword( uint32_t w )
+{
+    uint32_t s[AES_FS_WORDS];
+    unsigned char b[16] = { 0 };
+
+    PUT_UINT32_LE( w, b, 0 );
+    aes_fs_pack( s, b, b );
+    aes_fs_sbox( s );
+    aes_fs_unpack( b, b, s );
+    GET_UINT32_LE( w, b, 0 );
+    nbedtls_platform_zeroize( s, sizeof( s ) );
+    nbedtls_platform_zeroize( b, sizeof( b ) );
+
+    return( w );
+}
+
+/*
+ * AES-128 key schedule, the round key of round j is stored bitsliced for
+ * both blocks with SR^-(j mod 4) applied
+ */
+int nbedtls_aes_setkey_enc( nbedtls_aes_context *ctx, const unsigned char *key,
+                    unsigned int keybits )
+{
+    uint32_t W[4];
+    unsigned char rk[16], rks[16];
+    uint32_t rcon = 0x01;
+    int i, j, r, c;
+
+    AES_VALIDATE_RET( ctx != NULL );
+    AES_VALIDATE_RET( key != NULL );
+
+    if( keybits != 128 )
+        return( MBEDTLS_ERR_AES_INVALID_KEY_LENGTH );
+
+    ctx->nr = AES_FS_ROUNDS;
+    ctx->rk = ctx->buf;
+
+    for( i = 0; i < 4; i++ )
+        GET_UINT32_LE( W[i], key, 4 * i );
+
+    for( j = 0; j <= AES_FS_ROUNDS; j++ )
+    {
+        if( j > 0 )
+        {
+            W[0] ^= rcon ^ aes_fs_subword( ROR32( W[3], 8 ) );
+            W[1] ^= W[0];
+            W[2] ^= W[1];
+            W[3] ^= W[2];
+            rcon = ( ( rcon << 1 ) ^ ( ( rcon >> 7 ) * 0x1B ) ) & 0xFF;
+        }
+
+        for( i = 0; i < 4; i++ )
+            PUT_UINT32_LE( W[i], rk, 4 * i );
+
+        /* SR^-q: byte (r, c) comes from (r, c - q * r) */
+        for( r = 0; r < 4; r++ )
+            for( c = 0; c < 4; c++ )
+                rks[4 * c + r] = rk[4 * ( ( c - ( j & 3 ) * r ) & 3 ) + r];
+
+        aes_fs_pack( ctx->rk + AES_FS_WORDS * j, rks, rks );
+    }
+
+    nbedtls_platform_zeroize( W, sizeof( W ) );
+    nbedtls_platform_zeroize( rk, sizeof( rk ) );
+    nbedtls_platform_zeroize( rks, sizeof( rks ) );
+
+    return( 0 );
+}
+
+/*
+ * Two AES-128 block encryptions in one bitsliced pass
+ */
+int nbedtls_aes_crypt_ecb2( nbedtls_aes_context *ctx,
+                            const unsigned char input0[16],
+                            const unsigned char input1[16],
+                            unsigned char output0[16],
+                            unsigned char output1[16] )
+{
+    uint32_t s[AES_FS_WORDS];
+    const uint32_t *rk = ctx->rk;
+    int i;
+
+    AES_VALIDATE_RET( ctx != NULL );
+
+    aes_fs_pack( s, input0, input1 );
+    aes_fs_ark( s, rk );
+
+    /* rounds 1 to 8 in groups of four, the state is back in the plain
+     * layout after each group */
+    for( i = 0; i < 2; i++ )
+    {
+        aes_fs_sbox( s );
+        aes_fs_mixcolumns( s, 1 );
+        aes_fs_ark( s, rk += AES_FS_WORDS );
+        aes_fs_sbox( s );
+        aes_fs_mixcolumns( s, 2 );
+        aes_fs_ark( s, rk += AES_FS_WORDS );
+        aes_fs_sbox( s );
+        aes_fs_mixcolumns( s, 3 );
+        aes_fs_ark( s, rk += AES_FS_WORDS );
+        aes_fs_sbox( s );
+        aes_fs_mixcolumns( s, 0 );
+        aes_fs_ark( s, rk += AES_FS_WORDS );
+    }
+
+    aes_fs_sbox( s );
+    aes_fs_mixcolumns( s, 1 );
+    aes_fs_ark( s, rk += AES_FS_WORDS );
+    aes_fs_sbox( s );
+    aes_fs_ark( s, rk += AES_FS_WORDS );
+
+    /* SR^2 rotates rows 1 and 3 by two columns */
+    for( i = 0; i < AES_FS_WORDS; i++ )
+        s[i] = ( s[i] & 0x00FF00FF ) | byte_ror( s[i] & 0xFF00FF00, 4 );
+
+    aes_fs_unpack( output0, output1, s );
+    nbedtls_platform_zeroize( s, sizeof( s ) );
+
+    return( 0 );
+}
+
+int nbedtls_internal_aes_encrypt( nbedtls_aes_context *ctx,
+                                  const unsigned char input[16],
+                                  unsigned char output[16] )
+{
+    unsigned char unused[16];
+    int ret;
+
+    ret = nbedtls_aes_crypt_ecb2( ctx, input, input, output, unused );
+    nbedtls_platform_zeroize( unused, sizeof( unused ) );
+
+    return( ret );
+}
+
+#endif /* MBEDTLS_AES_FIXSLICED */
@@ -0,0 +1,237 @@
+/*
+ *  AES-NI and PCLMULQDQ support functions
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * [AES-WP] http://software.intel.com/en-us/articles/intel-advanced-encryption-standard-aes-instructions-set
+ * [CLMUL-WP] http://software.intel.com/en-us/articles/intel-carry-less-multiplication-instruction-and-its-usage-for-computing-the-gcm-mode/
+ *
+ * The functions are compiled for AES-NI, PCLMULQDQ and SSSE3 with target
+ * attributes, so the rest of the library keeps the baseline instruction set
+ * and only calls them after nbedtls_aesni_has_support().
+ */
+
+#include "aesni.h"
+
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+
+#include <string.h>
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define AESNI_TARGET __attribute__(( target( "aes,pclmul,ssse3" ) ))
+
+int nbedtls_aesni_has_support( unsigned int what )
+{
+    static int done = 0;
+    static unsigned int c = 0;
+    unsigned int a, b, d;
+
+    if( ! done )
+    {
+        if( __get_cpuid( 1, &a, &b, &c, &d ) == 0 )
+            c = 0;
+        done = 1;
+    }
+
+    return( ( c & what ) != 0 );
+}
+
+AESNI_TARGET
+int nbedtls_aesni_crypt_ecb( nbedtls_aes_context *ctx,
+                             int mode,
+                             const unsigned char input[16],
+                             unsigned char output[16] )
+{
+    const __m128i *rk = (const __m128i *) ctx->rk;
+    __m128i b = _mm_xor_si128( _mm_loadu_si128( (const __m128i *) input ),
+                               _mm_loadu_si128( rk ) );
+    int i;
+
+    if( mode == MBEDTLS_AES_ENCRYPT )
+    {
+        for( i = 1; i < ctx->nr; i++ )
+            b = _mm_aesenc_si128( b, _mm_loadu_si128( rk + i ) );
+        b = _mm_aesenclast_si128( b, _mm_loadu_si128( rk + ctx->nr ) );
+    }
+    else
+    {
+        for( i = 1; i < ctx->nr; i++ )
+            b = _mm_aesdec_si128( b, _mm_loadu_si128( rk + i ) );
+        b = _mm_aesdeclast_si128( b, _mm_loadu_si128( rk + ctx->nr ) );
+    }
+
+    _mm_storeu_si128( (__m128i *) output, b );
+
+    return( 0 );
+}
+
+/*
+ * Up to MBEDTLS_AESNI_CTR_BLOCKS independent blocks per round, so the
+ * latency of AESENC is hidden behind the other blocks
+ */
+AESNI_TARGET
+int nbedtls_aesni_crypt_ctr32( nbedtls_aes_context *ctx,
+                               unsigned char y[16],
+                               size_t nblocks,
+                               unsigned char *output )
+{
+    const __m128i *rk = (const __m128i *) ctx->rk;
+    const __m128i bswap = _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7,
+                                        8, 9, 10, 11, 12, 13, 14, 15 );
+    __m128i b[MBEDTLS_AESNI_CTR_BLOCKS], k;
+    __m128i ctr, prefix;
+    uint32_t n;
+    size_t j, count;
+    int i;
+
+    /* counter as a little-endian lane 0 after the byte swap, the other 96
+     * bits stay as they are */
+    ctr = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) y ), bswap );
+    n = (uint32_t) _mm_cvtsi128_si32( ctr );
+    prefix = _mm_and_si128( ctr, _mm_set_epi32( -1, -1, -1, 0 ) );
+
+    while( nblocks > 0 )
+    {
+        count = nblocks < MBEDTLS_AESNI_CTR_BLOCKS ?
+                nblocks : MBEDTLS_AESNI_CTR_BLOCKS;
+
+        k = _mm_loadu_si128( rk );
+        for( j = 0; j < count; j++ )
+        {
+            ctr = _mm_or_si128( prefix, _mm_cvtsi32_si128( (int) ++n ) );
+            b[j] = _mm_xor_si128( _mm_shuffle_epi8( ctr, bswap ), k );
+        }
+
+        for( i = 1; i < ctx->nr; i++ )
+        {
+            k = _mm_loadu_si128( rk + i );
+            for( j = 0; j < count; j++ )
+                b[j] = _mm_aesenc_si128( b[j], k );
+        }
+
+        k = _mm_loadu_si128( rk + ctx->nr );
+        for( j = 0; j < count; j++ )
+        {
+            b[j] = _mm_aesenclast_si128( b[j], k );
+            _mm_storeu_si128( (__m128i *) output + j, b[j] );
+        }
+
+        output += 16 * count;
+        nblocks -= count;
+    }
+
+    ctr = _mm_or_si128( prefix, _mm_cvtsi32_si128( (int) n ) );
+    _mm_storeu_si128( (__m128i *) y, _mm_shuffle_epi8( ctr, bswap ) );
+
+    return( 0 );
+}
+
+/*
+ * GF(2^128) multiplication of [CLMUL-WP] algorithm 5: the operands are byte
+ * reflected, the 256-bit products are added up, then shifted left by one bit
+ * for the bit reflection of GCM and reduced modulo x^128 + x^7 + x^2 + x + 1
+ * once for all of them ([CLMUL-WP] aggregated reduction).
+ */
+AESNI_TARGET
+static inline __m128i gcm_load( const unsigned char x[16] )
+{
+    const __m128i bswap = _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7,
+                                        8, 9, 10, 11, 12, 13, 14, 15 );
+
+    return( _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) x ), bswap ) );
+}
+
+/* Adds the 256-bit product a * b to hi:lo */
+AESNI_TARGET
+static inline void gcm_clmul_add( __m128i a, __m128i b,
+                                  __m128i *lo, __m128i *hi )
+{
+    __m128i mid;
+
+    mid = _mm_xor_si128( _mm_clmulepi64_si128( a, b, 0x10 ),
+                         _mm_clmulepi64_si128( a, b, 0x01 ) );
+    *lo = _mm_xor_si128( *lo, _mm_clmulepi64_si128( a, b, 0x00 ) );
+    *hi = _mm_xor_si128( *hi, _mm_clmulepi64_si128( a, b, 0x11 ) );
+    *lo = _mm_xor_si128( *lo, _mm_slli_si128( mid, 8 ) );
+    *hi = _mm_xor_si128( *hi, _mm_srli_si128( mid, 8 ) );
+}
+
+AESNI_TARGET
+static inline void gcm_reduce_store( unsigned char c[16], __m128i lo, __m128i hi )
+{
+    const __m128i bswap = _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7,
+                                        8, 9, 10, 11, 12, 13, 14, 15 );
+    __m128i t, u, v;
+
+    /* shift hi:lo left by one bit */
+    t = _mm_srli_epi32( lo, 31 );
+    u = _mm_srli_epi32( hi, 31 );
+    lo = _mm_slli_epi32( lo, 1 );
+    hi = _mm_slli_epi32( hi, 1 );
+    v = _mm_srli_si128( t, 12 );
+    u = _mm_slli_si128( u, 4 );
+    t = _mm_slli_si128( t, 4 );
+    lo = _mm_or_si128( lo, t );
+    hi = _mm_or_si128( hi, u );
+    hi = _mm_or_si128( hi, v );
+
+    /* reduction, first phase */
+    t = _mm_xor_si128( _mm_slli_epi32( lo, 31 ),
+                       _mm_xor_si128( _mm_slli_epi32( lo, 30 ),
+                                      _mm_slli_epi32( lo, 25 ) ) );
+    u = _mm_srli_si128( t, 4 );
+    lo = _mm_xor_si128( lo, _mm_slli_si128( t, 12 ) );
+
+    /* second phase */
+    t = _mm_xor_si128( _mm_srli_epi32( lo, 1 ),
+                       _mm_xor_si128( _mm_srli_epi32( lo, 2 ),
+                                      _mm_srli_epi32( lo, 7 ) ) );
+    t = _mm_xor_si128( t, u );
+    lo = _mm_xor_si128( lo, t );
+    hi = _mm_xor_si128( hi, lo );
+
+    _mm_storeu_si128( (__m128i *) c, _mm_shuffle_epi8( hi, bswap ) );
+}
+
+AESNI_TARGET
+void nbedtls_aesni_gcm_mult( unsigned char c[16],
+                             const unsigned char a[16],
+                             const unsigned char b[16] )
+{
+    __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+
+    gcm_clmul_add( gcm_load( a ), gcm_load( b ), &lo, &hi );
+    gcm_reduce_store( c, lo, hi );
+}
+
+AESNI_TARGET
+void nbedtls_aesni_gcm_mult4( unsigned char c[16],
+                              const unsigned char x[64],
+                              const unsigned char h[64] )
+{
+    __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+    int k;
+
+    for( k = 0; k < 4; k++ )
+        gcm_clmul_add( gcm_load( x + 16 * k ), gcm_load( h + 16 * ( 3 - k ) ),
+                       &lo, &hi );
+    gcm_reduce_store( c, lo, hi );
+}
+
+#endif /* MBEDTLS_AESNI_HAVE_CODE */
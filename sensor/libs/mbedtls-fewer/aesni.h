@@ -0,0 +1,129 @@
+/**
+ * \file aesni.h
+ *
+ * \brief   AES-NI and PCLMULQDQ for x86-64 hosts
+ *
+ *          Used by aes.c and gcm.c when MBEDTLS_AESNI_C is defined and
+ *          CPUID reports the instructions at run time, the table code stays
+ *          the fallback. The sensor build never defines MBEDTLS_AESNI_C.
+ */
+/*
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#ifndef MBEDTLS_AESNI_H
+#define MBEDTLS_AESNI_H
+
+#include "aes.h"
+
+#define MBEDTLS_AESNI_AES      0x02000000u  /**< CPUID.1:ECX bit 25 */
+#define MBEDTLS_AESNI_CLMUL    0x00000002u  /**< CPUID.1:ECX bit 1 */
+
+/** Counter blocks encrypted in flight by nbedtls_aesni_crypt_ctr32(). */
+#define MBEDTLS_AESNI_CTR_BLOCKS    8
+
+#if defined(MBEDTLS_AESNI_C) && defined(__x86_64__) && \
+    ( defined(__GNUC__) || defined(__clang__) )
+#define MBEDTLS_AESNI_HAVE_CODE
+#endif
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_AES_FIXSLICED)
+#error "MBEDTLS_AESNI_C needs the table key schedule, not MBEDTLS_AES_FIXSLICED"
+#endif
+
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          Tells whether the CPU supports an instruction set.
+ *
+ * \param what     #MBEDTLS_AESNI_AES or #MBEDTLS_AESNI_CLMUL.
+ *
+ * \return         1 if the CPU supports it, 0 otherwise.
+ */
+int nbedtls_aesni_has_support( unsigned int what );
+
+/**
+ * \brief          One AES block with AES-NI.
+ *
+ *                 The round keys are the ones of nbedtls_aes_setkey_enc()
+ *                 or nbedtls_aes_setkey_dec(), which hold the round key bytes
+ *                 in the order AESENC and AESDEC expect.
+ *
+ * \param ctx      The AES context, bound to a key.
+ * \param mode     #MBEDTLS_AES_ENCRYPT or #MBEDTLS_AES_DECRYPT.
+ * \param input    The input block.
+ * \param output   The output block.
+ *
+ * \return         \c 0.
+ */
+int nbedtls_aesni_crypt_ecb( nbedtls_aes_context *ctx,
+                             int mode,
+                             const unsigned char input[16],
+                             unsigned char output[16] );
+
+/**
+ * \brief          Keystream of \p nblocks counter blocks, as GCM uses them.
+ *
+ *                 The counter is the big-endian 32-bit word at the end of
+ *                 \p y. It is incremented before every block, so the first
+ *                 block is E(K, y + 1), and \p y holds the last counter
+ *                 block on return. Up to #MBEDTLS_AESNI_CTR_BLOCKS blocks
+ *                 go through the AES rounds together.
+ *
+ * \param ctx      The AES context, bound to an encryption key.
+ * \param y        The counter block.
+ * \param nblocks  The number of blocks.
+ * \param output   The keystream, \p nblocks * 16 Bytes.
+ *
+ * \return         \c 0.
+ */
+int nbedtls_aesni_crypt_ctr32( nbedtls_aes_context *ctx,
+                               unsigned char y[16],
+                               size_t nblocks,
+                               unsigned char *output );
+
+/**
+ * \brief          GCM multiplication c = a * b in GF(2^128) with PCLMULQDQ.
+ *
+ * \param c        The result.
+ * \param a        The first operand, in the GCM byte order.
+ * \param b        The second operand, in the GCM byte order.
+ */
+void nbedtls_aesni_gcm_mult( unsigned char c[16],
+                             const unsigned char a[16],
+                             const unsigned char b[16] );
+
+/**
+ * \brief          Four GCM multiplications with one reduction,
+ *                 c = x_0 * H^4 + x_1 * H^3 + x_2 * H^2 + x_3 * H.
+ *
+ * \param c        The result.
+ * \param x        The four blocks, in the GCM byte order.
+ * \param h        H, H^2, H^3 and H^4, in the GCM byte order.
+ */
+void nbedtls_aesni_gcm_mult4( unsigned char c[16],
+                              const unsigned char x[64],
+                              const unsigned char h[64] );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_AESNI_HAVE_CODE */
+
+#endif /* aesni.h */
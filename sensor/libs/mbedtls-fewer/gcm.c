@@ -27,12 +27,22 @@
  *
  * We use the algorithm described as Shoup's method with 4-bit tables in
  * [MGV] 4.1, pp. 12-13, to enhance speed without using too much memory.
+ *
+ * With MBEDTLS_AESNI_C on x86-64 hosts, PCLMULQDQ replaces the tables and
+ * AES-NI encrypts MBEDTLS_AESNI_CTR_BLOCKS counter blocks at a time when the
+ * CPU supports them.
+ *
+ * With MBEDTLS_GCM_FUSED, nbedtls_gcm_update() takes the whole blocks of a
+ * call in one loop that encrypts the next counter blocks before the GHASH
+ * of the current ones and XORs 32-bit words, the byte path is left for the
+ * tail.
  */
 
 #include "platform_util.h"
 
 #include "gcm.h"
 #include "aes.h"
+#include "aesni.h"
 #include "api.h"
 #include "crypto_aead.h"
 
@@ -81,6 +91,20 @@ void nbedtls_gcm_init( nbedtls_gcm_context *ctx )
 #define nbedtls_cipher_update(ctx, input, output) \
 	nbedtls_aes_crypt_ecb((ctx)->cipher_ctx, MBEDTLS_ENCRYPT, input, output)
 
+/* Two counter blocks per call, one bitsliced pass with MBEDTLS_AES_FIXSLICED */
+#define nbedtls_cipher_update2(ctx, input0, input1, output0, output1) \
+	nbedtls_aes_crypt_ecb2((ctx)->cipher_ctx, input0, input1, output0, output1)
+
+/* Increments the 32-bit counter of a counter block */
+static void gcm_incr( unsigned char y[16] )
+{
+    size_t i;
+
+    for( i = 16; i > 12; i-- )
+        if( ++y[i - 1] != 0 )
+            break;
+}
+
 /*
  * Encrypt function for NIST API
 */
@@ -94,22 +118,12 @@ int crypto_aead_encrypt(
       )
 {
   (void) nsec;
-  nbedtls_gcm_context ctx;
-  nbedtls_aes_context aes;
+  nbedtls_gcm_aead_context ctx;
   int ret;
-//   unsigned long long mask = 15;
-//   unsigned long long mlenp = (mlen + mask) & (~mask);
-  unsigned char tag_buf[CRYPTO_ABYTES];
-//  *clen = mlenp + CRYPTO_ABYTES;
-  *clen = mlen + CRYPTO_ABYTES;
-  nbedtls_gcm_init( &ctx );
-  ctx.cipher_ctx.cipher_ctx = &aes;
-  ret = nbedtls_gcm_setkey( &ctx, k, 128);
-  ret = nbedtls_gcm_crypt_and_tag( &ctx, 1, mlen, npub, 12, ad, adlen, m, c, 16, tag_buf );
-  nbedtls_gcm_free( &ctx );
-  nbedtls_platform_zeroize( &aes, sizeof( aes ) );
-  //memcpy(c + mlenp, tag_buf, CRYPTO_ABYTES);
-  memcpy(c + mlen, tag_buf, CRYPTO_ABYTES);
+
+  nbedtls_gcm_aead_setkey( &ctx, k );
+  ret = nbedtls_gcm_aead_seal( &ctx, c, clen, m, mlen, ad, adlen, npub );
+  nbedtls_gcm_aead_free( &ctx );
 
   return ret;
 }
@@ -124,44 +138,31 @@ int crypto_aead_decrypt(
 )
 {
   (void) nsec;
-  nbedtls_gcm_context ctx;
-  nbedtls_aes_context aes;
+  nbedtls_gcm_aead_context ctx;
   int ret;
-  unsigned char tag_buf[CRYPTO_ABYTES];
-  
-  clen -= CRYPTO_ABYTES;
-  memcpy(tag_buf, c + clen, CRYPTO_ABYTES);
-  *mlen = clen;
-
-  nbedtls_gcm_init( &ctx );
-  ctx.cipher_ctx.cipher_ctx = &aes;
-  ret = nbedtls_gcm_setkey( &ctx, k, 128);
-  ret = nbedtls_gcm_auth_decrypt( &ctx, clen, npub, 12, ad, adlen, tag_buf, 16, c, m);
-  nbedtls_gcm_free( &ctx );
-  nbedtls_platform_zeroize( &aes, sizeof( aes ) );
-  
+
+  nbedtls_gcm_aead_setkey( &ctx, k );
+  ret = nbedtls_gcm_aead_open( &ctx, m, mlen, c, clen, ad, adlen, npub );
+  nbedtls_gcm_aead_free( &ctx );
+
   return ret;
 
 }
 /*
- * Precompute small multiples of H, that is set
- *      HH[i] || HL[i] = H times i,
+ * Precompute small multiples of a power of H, that is set
+ *      HH[i] || HL[i] = H^p times i,
  * where i is seen as a field element as in [MGV], ie high-order bits
  * correspond to low powers of P. The result is stored in the same way, that
  * is the high-order bit of HH corresponds to P^0 and the low-order bit of HL
  * corresponds to P^127.
  */
-
-static int gcm_gen_table( nbedtls_gcm_context *ctx )
+static void gcm_gen_table_power( uint64_t HL[MBEDTLS_GCM_HTABLE_SIZE],
+                                 uint64_t HH[MBEDTLS_GCM_HTABLE_SIZE],
+                                 const unsigned char h[16] )
 {
-    int ret, i, j;
+    int i, j;
     uint64_t hi, lo;
     uint64_t vl, vh;
-    unsigned char h[16];
-
-    memset( h, 0, 16 );
-    if( ( ret = nbedtls_cipher_update( &ctx->cipher_ctx, h, h ) ) != 0 )
-        return( ret );
 
     /* pack h as two 64-bits ints, big-endian */
     GET_UINT32_BE( hi, h,  0  );
@@ -172,61 +173,39 @@ static int gcm_gen_table( nbedtls_gcm_context *ctx )
     GET_UINT32_BE( lo, h,  12 );
     vl = (uint64_t) hi << 32 | lo;
 
-    /* 8 = 1000 corresponds to 1 in GF(2^128) */
-    ctx->HL[8] = vl;
-    ctx->HH[8] = vh;
+    /* 8 = 1000 (128 = 10000000 for 8-bit tables) corresponds to 1 in
+     * GF(2^128) */
+    HL[MBEDTLS_GCM_HTABLE_SIZE / 2] = vl;
+    HH[MBEDTLS_GCM_HTABLE_SIZE / 2] = vh;
 
     /* 0 corresponds to 0 in GF(2^128) */
-    ctx->HH[0] = 0;
-    ctx->HL[0] = 0;
+    HH[0] = 0;
+    HL[0] = 0;
 
-    for( i = 4; i > 0; i >>= 1 )
+    for( i = MBEDTLS_GCM_HTABLE_SIZE / 4; i > 0; i >>= 1 )
     {
         uint32_t T = ( vl & 1 ) * 0xe1000000U;
         vl  = ( vh << 63 ) | ( vl >> 1 );
         vh  = ( vh >> 1 ) ^ ( (uint64_t) T << 32);
 
-        ctx->HL[i] = vl;
-        ctx->HH[i] = vh;
+        HL[i] = vl;
+        HH[i] = vh;
     }
 
-    for( i = 2; i <= 8; i *= 2 )
+    for( i = 2; i <= MBEDTLS_GCM_HTABLE_SIZE / 2; i *= 2 )
     {
-        uint64_t *HiL = ctx->HL + i, *HiH = ctx->HH + i;
+        uint64_t *HiL = HL + i, *HiH = HH + i;
         vh = *HiH;
         vl = *HiL;
         for( j = 1; j < i; j++ )
         {
-            HiH[j] = vh ^ ctx->HH[j];
-            HiL[j] = vl ^ ctx->HL[j];
+            HiH[j] = vh ^ HH[j];
+            HiL[j] = vl ^ HL[j];
         }
     }
-
-    return( 0 );
-}
-
-int nbedtls_gcm_setkey( nbedtls_gcm_context *ctx,
-                        const unsigned char *key,
-                        unsigned int keybits )
-{
-    int ret;
-
-    GCM_VALIDATE_RET( ctx != NULL );
-    GCM_VALIDATE_RET( key != NULL );
-    GCM_VALIDATE_RET( keybits == 128 || keybits == 192 || keybits == 256 );
-
-    ctx->cipher_ctx.key_bitlen = keybits;
-
-    if( ( ret = nbedtls_aes_setkey_enc( ctx->cipher_ctx.cipher_ctx, key, keybits ) ) != 0)
-    {
-        return( ret );
-    }
-    if( ( ret = gcm_gen_table( ctx ) ) != 0 )
-        return( ret );
-
-    return( 0 );
 }
 
+#if !defined(MBEDTLS_GCM_8BIT_TABLES)
 /*
  * Shoup's method for multiplication use this table with
  *      last4[x] = x times P^128
@@ -239,45 +218,103 @@ static const uint64_t last4[16] =
     0xe100, 0xfd20, 0xd940, 0xc560,
     0x9180, 0x8da0, 0xa9c0, 0xb5e0
 };
-
+#else
 /*
- * Sets output to x times H using the precomputed tables.
- * x and output are seen as elements of GF(2^128) as in [MGV].
+ * The same for the 8 bits shifted out by one step of the 8-bit tables,
+ *      last8[x] = x times P^128
  */
-static void gcm_mult( nbedtls_gcm_context *ctx, const unsigned char x[16],
-                      unsigned char output[16] )
+static const uint16_t last8[256] =
 {
-    int i = 0;
-    unsigned char lo, hi, rem;
-    uint64_t zh, zl;
-
-    lo = x[15] & 0xf;
+    0x0000, 0x01c2, 0x0384, 0x0246, 0x0708, 0x06ca, 0x048c, 0x054e,
+    0x0e10, 0x0fd2, 0x0d94, 0x0c56, 0x0918, 0x08da, 0x0a9c, 0x0b5e,
+    0x1c20, 0x1de2, 0x1fa4, 0x1e66, 0x1b28, 0x1aea, 0x18ac, 0x196e,
+    0x1230, 0x13f2, 0x11b4, 0x1076, 0x1538, 0x14fa, 0x16bc, 0x177e,
+    0x3840, 0x3982, 0x3bc4, 0x3a06, 0x3f48, 0x3e8a, 0x3ccc, 0x3d0e,
+    0x3650, 0x3792, 0x35d4, 0x3416, 0x3158, 0x309a, 0x32dc, 0x331e,
+    0x2460, 0x25a2, 0x27e4, 0x2626, 0x2368, 0x22aa, 0x20ec, 0x212e,
+    0x2a70, 0x2bb2, 0x29f4, 0x2836, 0x2d78, 0x2cba, 0x2efc, 0x2f3e,
+    0x7080, 0x7142, 0x7304, 0x72c6, 0x7788, 0x764a, 0x740c, 0x75ce,
+    0x7e90, 0x7f52, 0x7d14, 0x7cd6, 0x7998, 0x785a, 0x7a1c, 0x7bde,
+    0x6ca0, 0x6d62, 0x6f24, 0x6ee6, 0x6ba8, 0x6a6a, 0x682c, 0x69ee,
+    0x62b0, 0x6372, 0x6134, 0x60f6, 0x65b8, 0x647a, 0x663c, 0x67fe,
+    0x48c0, 0x4902, 0x4b44, 0x4a86, 0x4fc8, 0x4e0a, 0x4c4c, 0x4d8e,
+    0x46d0, 0x4712, 0x4554, 0x4496, 0x41d8, 0x401a, 0x425c, 0x439e,
+    0x54e0, 0x5522, 0x5764, 0x56a6, 0x53e8, 0x522a, 0x506c, 0x51ae,
+    0x5af0, 0x5b32, 0x5974, 0x58b6, 0x5df8, 0x5c3a, 0x5e7c, 0x5fbe,
+    0xe100, 0xe0c2, 0xe284, 0xe346, 0xe608, 0xe7ca, 0xe58c, 0xe44e,
+    0xef10, 0xeed2, 0xec94, 0xed56, 0xe818, 0xe9da, 0xeb9c, 0xea5e,
+    0xfd20, 0xfce2, 0xfea4, 0xff66, 0xfa28, 0xfbea, 0xf9ac, 0xf86e,
+    0xf330, 0xf2f2, 0xf0b4, 0xf176, 0xf438, 0xf5fa, 0xf7bc, 0xf67e,
+    0xd940, 0xd882, 0xdac4, 0xdb06, 0xde48, 0xdf8a, 0xddcc, 0xdc0e,
+    0xd750, 0xd692, 0xd4d4, 0xd516, 0xd058, 0xd19a, 0xd3dc, 0xd21e,
+    0xc560, 0xc4a2, 0xc6e4, 0xc726, 0xc268, 0xc3aa, 0xc1ec, 0xc02e,
+    0xcb70, 0xcab2, 0xc8f4, 0xc936, 0xcc78, 0xcdba, 0xcffc, 0xce3e,
+    0x9180, 0x9042, 0x9204, 0x93c6, 0x9688, 0x974a, 0x950c, 0x94ce,
+    0x9f90, 0x9e52, 0x9c14, 0x9dd6, 0x9898, 0x995a, 0x9b1c, 0x9ade,
+    0x8da0, 0x8c62, 0x8e24, 0x8fe6, 0x8aa8, 0x8b6a, 0x892c, 0x88ee,
+    0x83b0, 0x8272, 0x8034, 0x81f6, 0x84b8, 0x857a, 0x873c, 0x86fe,
+    0xa9c0, 0xa802, 0xaa44, 0xab86, 0xaec8, 0xaf0a, 0xad4c, 0xac8e,
+    0xa7d0, 0xa612, 0xa454, 0xa596, 0xa0d8, 0xa11a, 0xa35c, 0xa29e,
+    0xb5e0, 0xb422, 0xb664, 0xb7a6, 0xb2e8, 0xb32a, 0xb16c, 0xb0ae,
+    0xbbf0, 0xba32, 0xb874, 0xb9b6, 0xbcf8, 0xbd3a, 0xbf7c, 0xbebe,
+};
+#endif /* !MBEDTLS_GCM_8BIT_TABLES */
 
-    zh = ctx->HH[lo];
-    zl = ctx->HL[lo];
+/*
+ * Sets output to the sum of the n blocks x[k] times H^(n - k), with the
+ * precomputed tables of the powers of H. Every table lookup of a block is
+ * added before the shared shift and reduction of z, so n blocks cost one
+ * reduction per nibble (byte) and not n. x and output are seen as elements
+ * of GF(2^128) as in [MGV].
+ */
+static inline void gcm_mult_tables( const nbedtls_gcm_context *ctx,
+                                    const unsigned char *x, int n,
+                                    unsigned char output[16] )
+{
+    int i, k;
+    unsigned char rem;
+    uint64_t zh = 0, zl = 0;
 
     for( i = 15; i >= 0; i-- )
     {
-        lo = x[i] & 0xf;
-        hi = x[i] >> 4;
+#if defined(MBEDTLS_GCM_8BIT_TABLES)
+        rem = (unsigned char) zl;
+        zl = ( zh << 56 ) | ( zl >> 8 );
+        zh = ( zh >> 8 );
+        zh ^= (uint64_t) last8[rem] << 48;
 
-        if( i != 15 )
+        for( k = 0; k < n; k++ )
         {
-            rem = (unsigned char) zl & 0xf;
-            zl = ( zh << 60 ) | ( zl >> 4 );
-            zh = ( zh >> 4 );
-            zh ^= (uint64_t) last4[rem] << 48;
-            zh ^= ctx->HH[lo];
-            zl ^= ctx->HL[lo];
+            zh ^= ctx->HH[n - 1 - k][x[16 * k + i]];
+            zl ^= ctx->HL[n - 1 - k][x[16 * k + i]];
+        }
+#else
+        unsigned char lo, hi;
+
+        rem = (unsigned char) zl & 0xf;
+        zl = ( zh << 60 ) | ( zl >> 4 );
+        zh = ( zh >> 4 );
+        zh ^= (uint64_t) last4[rem] << 48;
 
+        for( k = 0; k < n; k++ )
+        {
+            lo = x[16 * k + i] & 0xf;
+            zh ^= ctx->HH[n - 1 - k][lo];
+            zl ^= ctx->HL[n - 1 - k][lo];
         }
 
         rem = (unsigned char) zl & 0xf;
         zl = ( zh << 60 ) | ( zl >> 4 );
         zh = ( zh >> 4 );
         zh ^= (uint64_t) last4[rem] << 48;
-        zh ^= ctx->HH[hi];
-        zl ^= ctx->HL[hi];
+
+        for( k = 0; k < n; k++ )
+        {
+            hi = x[16 * k + i] >> 4;
+            zh ^= ctx->HH[n - 1 - k][hi];
+            zl ^= ctx->HL[n - 1 - k][hi];
+        }
+#endif /* MBEDTLS_GCM_8BIT_TABLES */
     }
 
     PUT_UINT32_BE( zh >> 32, output, 0 );
@@ -286,6 +323,129 @@ static void gcm_mult( nbedtls_gcm_context *ctx, const unsigned char x[16],
     PUT_UINT32_BE( zl, output, 12 );
 }
 
+/*
+ * Sets output to x times H using the precomputed tables.
+ * x and output are seen as elements of GF(2^128) as in [MGV].
+ */
+static void gcm_mult( nbedtls_gcm_context *ctx, const unsigned char x[16],
+                      unsigned char output[16] )
+{
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+    if( nbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL ) )
+    {
+        nbedtls_aesni_gcm_mult( output, x, ctx->h[0] );
+        return;
+    }
+#endif
+
+    gcm_mult_tables( ctx, x, 1, output );
+}
+
+#if defined(MBEDTLS_GCM_AGGREGATE)
+/*
+ * GHASH of four blocks, buf = (buf + x[0]) H^4 + x[1] H^3 + x[2] H^2 + x[3] H
+ */
+static void gcm_mult4( nbedtls_gcm_context *ctx, const unsigned char x[64] )
+{
+    unsigned char a[64];
+    size_t i;
+
+    memcpy( a, x, 64 );
+    for( i = 0; i < 16; i++ )
+        a[i] ^= ctx->buf[i];
+
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+    if( nbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL ) )
+    {
+        nbedtls_aesni_gcm_mult4( ctx->buf, a, (const unsigned char *) ctx->h );
+        return;
+    }
+#endif
+
+    gcm_mult_tables( ctx, a, 4, ctx->buf );
+}
+#endif /* MBEDTLS_GCM_AGGREGATE */
+
+/*
+ * H = E(K, 0) and the tables of its powers, with CLMUL support only the
+ * powers themselves
+ */
+static int gcm_gen_table( nbedtls_gcm_context *ctx )
+{
+    int ret, p;
+    unsigned char h[16], hp[16];
+
+    memset( h, 0, 16 );
+    if( ( ret = nbedtls_cipher_update( &ctx->cipher_ctx, h, h ) ) != 0 )
+        return( ret );
+
+    memcpy( hp, h, 16 );
+    for( p = 0; p < MBEDTLS_GCM_HPOWERS; p++ )
+    {
+        /* H^(p + 1) with the table (or CLMUL) of H */
+        if( p > 0 )
+            gcm_mult( ctx, hp, hp );
+
+#if defined(MBEDTLS_AESNI_C)
+        memcpy( ctx->h[p], hp, 16 );
+#endif
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+        /* With CLMUL support, we need only h, not the rest of the table */
+        if( nbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL ) )
+            continue;
+#endif
+
+        gcm_gen_table_power( ctx->HL[p], ctx->HH[p], hp );
+    }
+
+    return( 0 );
+}
+
+int nbedtls_gcm_setkey( nbedtls_gcm_context *ctx,
+                        const unsigned char *key,
+                        unsigned int keybits )
+{
+    int ret;
+
+    GCM_VALIDATE_RET( ctx != NULL );
+    GCM_VALIDATE_RET( key != NULL );
+    GCM_VALIDATE_RET( keybits == 128 || keybits == 192 || keybits == 256 );
+
+    ctx->cipher_ctx.key_bitlen = keybits;
+
+    if( ( ret = nbedtls_aes_setkey_enc( ctx->cipher_ctx.cipher_ctx, key, keybits ) ) != 0)
+    {
+        return( ret );
+    }
+    if( ( ret = gcm_gen_table( ctx ) ) != 0 )
+        return( ret );
+
+    return( 0 );
+}
+
+/*
+ * GHASH of the additional data
+ */
+static void gcm_add( nbedtls_gcm_context *ctx,
+                     const unsigned char *add, size_t add_len )
+{
+    size_t i, use_len;
+
+    ctx->add_len = add_len;
+    while( add_len > 0 )
+    {
+        use_len = ( add_len < 16 ) ? add_len : 16;
+
+        for( i = 0; i < use_len; i++ )
+            ctx->buf[i] ^= add[i];
+
+        gcm_mult( ctx, ctx->buf, ctx->buf );
+
+        add_len -= use_len;
+        add += use_len;
+    }
+}
+
 int nbedtls_gcm_starts( nbedtls_gcm_context *ctx,
                 int mode,
                 const unsigned char *iv,
@@ -348,29 +508,253 @@ int nbedtls_gcm_starts( nbedtls_gcm_context *ctx,
         gcm_mult( ctx, ctx->y, ctx->y );
     }
 
-    if( ( ret = nbedtls_cipher_update( &ctx->cipher_ctx, ctx->y,
-                                       ctx->base_ectr ) ) != 0 )
+    /* E(K, J0) for the tag and the ECTR of the first message block */
+    memcpy( work_buf, ctx->y, 16 );
+    gcm_incr( work_buf );
+    if( ( ret = nbedtls_cipher_update2( &ctx->cipher_ctx, ctx->y, work_buf,
+                                        ctx->base_ectr, ctx->ectr ) ) != 0 )
     {
         return( ret );
     }
+    ctx->ectr_ready = 1;
 
-    ctx->add_len = add_len;
-    p = add;
-    while( add_len > 0 )
+    gcm_add( ctx, add, add_len );
+
+    return( 0 );
+}
+
+/*
+ * ECTR of the next n counter blocks. Two counter blocks go through AES per
+ * call, the ECTR of the block after the last one is cached when more data
+ * follows.
+ */
+static int gcm_ectr( nbedtls_gcm_context *ctx, unsigned char *ectr,
+                     size_t n, int more )
+{
+    int ret;
+    unsigned char y_next[16];
+
+    while( n > 0 )
     {
-        use_len = ( add_len < 16 ) ? add_len : 16;
+        gcm_incr( ctx->y );
 
-        for( i = 0; i < use_len; i++ )
-            ctx->buf[i] ^= p[i];
+        if( ctx->ectr_ready )
+        {
+            memcpy( ectr, ctx->ectr, 16 );
+            ctx->ectr_ready = 0;
+            ectr += 16;
+            n--;
+            continue;
+        }
 
+        if( n == 1 && ! more )
+            return( nbedtls_cipher_update( &ctx->cipher_ctx, ctx->y, ectr ) );
+
+        memcpy( y_next, ctx->y, 16 );
+        gcm_incr( y_next );
+
+        if( n == 1 )
+        {
+            /* This block and the next one, the next ECTR is kept */
+            if( ( ret = nbedtls_cipher_update2( &ctx->cipher_ctx, ctx->y,
+                                        y_next, ectr, ctx->ectr ) ) != 0 )
+            {
+                return( ret );
+            }
+            ctx->ectr_ready = 1;
+            break;
+        }
+
+        if( ( ret = nbedtls_cipher_update2( &ctx->cipher_ctx, ctx->y,
+                                            y_next, ectr, ectr + 16 ) ) != 0 )
+        {
+            return( ret );
+        }
+        memcpy( ctx->y, y_next, 16 );
+        ectr += 32;
+        n -= 2;
+    }
+
+    return( 0 );
+}
+
+/*
+ * XORs one block with its ECTR and adds the ciphertext to GHASH
+ */
+static void gcm_crypt_block( nbedtls_gcm_context *ctx,
+                             const unsigned char ectr[16], size_t use_len,
+                             const unsigned char *input,
+                             unsigned char *output )
+{
+    size_t i;
+
+    for( i = 0; i < use_len; i++ )
+    {
+        if( ctx->mode == MBEDTLS_GCM_DECRYPT )
+            ctx->buf[i] ^= input[i];
+        output[i] = ectr[i] ^ input[i];
+        if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
+            ctx->buf[i] ^= output[i];
+    }
+
+    gcm_mult( ctx, ctx->buf, ctx->buf );
+}
+
+/*
+ * The same for whole blocks, GHASH takes four blocks per reduction with
+ * MBEDTLS_GCM_AGGREGATE
+ */
+static void gcm_crypt_blocks( nbedtls_gcm_context *ctx,
+                              const unsigned char *ectr, size_t nblocks,
+                              const unsigned char *input,
+                              unsigned char *output )
+{
+#if defined(MBEDTLS_GCM_AGGREGATE)
+    size_t i;
+
+    for( ; nblocks >= 4; nblocks -= 4 )
+    {
+        /* the ciphertext is hashed before an in-place decryption
+         * overwrites it */
+        if( ctx->mode == MBEDTLS_GCM_DECRYPT )
+            gcm_mult4( ctx, input );
+        for( i = 0; i < 64; i++ )
+            output[i] = ectr[i] ^ input[i];
+        if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
+            gcm_mult4( ctx, output );
+
+        ectr += 64;
+        input += 64;
+        output += 64;
+    }
+#endif
+
+    for( ; nblocks > 0; nblocks-- )
+    {
+        gcm_crypt_block( ctx, ectr, 16, input, output );
+        ectr += 16;
+        input += 16;
+        output += 16;
+    }
+}
+
+#if defined(MBEDTLS_GCM_FUSED)
+#if defined(MBEDTLS_GCM_AGGREGATE)
+#define GCM_FUSED_BLOCKS    4   /* one GHASH step */
+#else
+#define GCM_FUSED_BLOCKS    2   /* one nbedtls_cipher_update2() */
+#endif
+
+#if defined(__GNUC__)
+typedef uint32_t __attribute__(( __may_alias__ )) gcm_word;
+#else
+typedef uint32_t gcm_word;
+#endif
+
+/*
+ * output = a ^ b, in 32-bit words when the three buffers are aligned (the
+ * Cortex-M0+ faults on unaligned word accesses)
+ */
+static void gcm_xor( unsigned char *output, const unsigned char *a,
+                     const unsigned char *b, size_t len )
+{
+    size_t i = 0;
+
+    if( ( ( (uintptr_t) output | (uintptr_t) a | (uintptr_t) b ) & 3 ) == 0 )
+    {
+        for( ; i + 4 <= len; i += 4 )
+            *(gcm_word *) ( output + i ) = *(const gcm_word *) ( a + i ) ^
+                                           *(const gcm_word *) ( b + i );
+    }
+
+    for( ; i < len; i++ )
+        output[i] = a[i] ^ b[i];
+}
+
+/*
+ * XORs n whole blocks with their ECTR and adds the ciphertext to GHASH
+ */
+static void gcm_fused_hash( nbedtls_gcm_context *ctx,
+                            const unsigned char *ectr, size_t n,
+                            const unsigned char *input,
+                            unsigned char *output )
+{
+#if defined(MBEDTLS_GCM_AGGREGATE)
+    if( n == 4 )
+    {
+        if( ctx->mode == MBEDTLS_GCM_DECRYPT )
+            gcm_mult4( ctx, input );
+        gcm_xor( output, ectr, input, 64 );
+        if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
+            gcm_mult4( ctx, output );
+        return;
+    }
+#endif
+
+    for( ; n > 0; n-- )
+    {
+        if( ctx->mode == MBEDTLS_GCM_DECRYPT )
+            gcm_xor( ctx->buf, ctx->buf, input, 16 );
+        gcm_xor( output, ectr, input, 16 );
+        if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
+            gcm_xor( ctx->buf, ctx->buf, output, 16 );
         gcm_mult( ctx, ctx->buf, ctx->buf );
 
-        add_len -= use_len;
-        p += use_len;
+        ectr += 16;
+        input += 16;
+        output += 16;
     }
+}
+
+/*
+ * nblocks whole blocks, software pipelined: the AES of the next
+ * GCM_FUSED_BLOCKS counter blocks runs before the GHASH of the current ones,
+ * which does not depend on it, so an out-of-order core overlaps the two and
+ * the loop makes one pass over the data. more tells whether a partial block
+ * follows.
+ */
+static int gcm_crypt_fused( nbedtls_gcm_context *ctx, size_t nblocks,
+                            int more, const unsigned char *input,
+                            unsigned char *output )
+{
+    int ret;
+    uint32_t ectr[2][GCM_FUSED_BLOCKS * 4];
+    unsigned char *cur = (unsigned char *) ectr[0];
+    unsigned char *next = (unsigned char *) ectr[1];
+    unsigned char *t;
+    size_t n, n_next;
+
+    n = nblocks < GCM_FUSED_BLOCKS ? nblocks : GCM_FUSED_BLOCKS;
+    if( ( ret = gcm_ectr( ctx, cur, n, nblocks > n || more ) ) != 0 )
+        return( ret );
+
+    while( nblocks > 0 )
+    {
+        nblocks -= n;
+        n_next = nblocks < GCM_FUSED_BLOCKS ? nblocks : GCM_FUSED_BLOCKS;
+
+        if( n_next > 0 &&
+            ( ret = gcm_ectr( ctx, next, n_next,
+                              nblocks > n_next || more ) ) != 0 )
+        {
+            return( ret );
+        }
+
+        gcm_fused_hash( ctx, cur, n, input, output );
+
+        input += 16 * n;
+        output += 16 * n;
+        t = cur;
+        cur = next;
+        next = t;
+        n = n_next;
+    }
+
+    nbedtls_platform_zeroize( ectr, sizeof( ectr ) );
 
     return( 0 );
 }
+#endif /* MBEDTLS_GCM_FUSED */
 
 int nbedtls_gcm_update( nbedtls_gcm_context *ctx,
                 size_t length,
@@ -379,7 +763,12 @@ int nbedtls_gcm_update( nbedtls_gcm_context *ctx,
 {
     int ret;
     unsigned char ectr[16];
-    size_t i;
+#if defined(MBEDTLS_GCM_AGGREGATE)
+    unsigned char ectr4[64];
+#endif
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+    unsigned char ectr_n[16 * MBEDTLS_AESNI_CTR_BLOCKS];
+#endif
     const unsigned char *p;
     unsigned char *out_p = output;
     size_t use_len;
@@ -406,26 +795,47 @@ int nbedtls_gcm_update( nbedtls_gcm_context *ctx,
     {
         use_len = ( length < 16 ) ? length : 16;
 
-        for( i = 16; i > 12; i-- )
-            if( ++ctx->y[i - 1] != 0 )
-                break;
-
-        if( ( ret = nbedtls_cipher_update( &ctx->cipher_ctx, ctx->y, ectr
-                                    ) ) != 0 )
+#if defined(MBEDTLS_AESNI_HAVE_CODE)
+        if( ! ctx->ectr_ready && length >= sizeof( ectr_n ) &&
+            nbedtls_aesni_has_support( MBEDTLS_AESNI_AES ) )
         {
-            return( ret );
+            nbedtls_aesni_crypt_ctr32( ctx->cipher_ctx.cipher_ctx, ctx->y,
+                                       MBEDTLS_AESNI_CTR_BLOCKS, ectr_n );
+            use_len = sizeof( ectr_n );
+            gcm_crypt_blocks( ctx, ectr_n, MBEDTLS_AESNI_CTR_BLOCKS, p, out_p );
         }
-
-        for( i = 0; i < use_len; i++ )
+        else
+#endif
+#if defined(MBEDTLS_GCM_FUSED)
+        if( length >= 16 )
         {
-            if( ctx->mode == MBEDTLS_GCM_DECRYPT )
-                ctx->buf[i] ^= p[i];
-            out_p[i] = ectr[i] ^ p[i];
-            if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
-                ctx->buf[i] ^= out_p[i];
+            use_len = length & ~(size_t) 15;
+            if( ( ret = gcm_crypt_fused( ctx, use_len / 16, length > use_len,
+                                         p, out_p ) ) != 0 )
+            {
+                return( ret );
+            }
+        }
+        else
+#endif
+#if defined(MBEDTLS_GCM_AGGREGATE)
+        if( length >= sizeof( ectr4 ) )
+        {
+            if( ( ret = gcm_ectr( ctx, ectr4, 4,
+                                  length > sizeof( ectr4 ) ) ) != 0 )
+            {
+                return( ret );
+            }
+            use_len = sizeof( ectr4 );
+            gcm_crypt_blocks( ctx, ectr4, 4, p, out_p );
+        }
+        else
+#endif
+        {
+            if( ( ret = gcm_ectr( ctx, ectr, 1, length > 16 ) ) != 0 )
+                return( ret );
+            gcm_crypt_block( ctx, ectr, use_len, p, out_p );
         }
-
-        gcm_mult( ctx, ctx->buf, ctx->buf );
 
         length -= use_len;
         p += use_len;
@@ -559,3 +969,176 @@ void nbedtls_gcm_free( nbedtls_gcm_context *ctx )
     nbedtls_platform_zeroize( ctx, sizeof( nbedtls_gcm_context ) );
 }
 
+/*
+ * Keyed context: the round keys and HH/HL tables stay, the per-message
+ * state (counter, E(K, J0), cached ECTR, GHASH accumulator) is wiped after
+ * every message
+ */
+static void gcm_aead_reset( nbedtls_gcm_context *ctx )
+{
+    nbedtls_platform_zeroize( ctx->base_ectr, sizeof( ctx->base_ectr ) );
+    nbedtls_platform_zeroize( ctx->ectr, sizeof( ctx->ectr ) );
+    ctx->ectr_ready = 0;
+    nbedtls_platform_zeroize( ctx->y, sizeof( ctx->y ) );
+    nbedtls_platform_zeroize( ctx->buf, sizeof( ctx->buf ) );
+    ctx->len = 0;
+    ctx->add_len = 0;
+}
+
+int nbedtls_gcm_aead_setkey( nbedtls_gcm_aead_context *ctx,
+                             const unsigned char *key )
+{
+    GCM_VALIDATE_RET( ctx != NULL );
+    GCM_VALIDATE_RET( key != NULL );
+
+    nbedtls_gcm_init( &ctx->gcm );
+    ctx->gcm.cipher_ctx.cipher_ctx = &ctx->aes;
+    return( nbedtls_gcm_setkey( &ctx->gcm, key, 128 ) );
+}
+
+int nbedtls_gcm_aead_seal( nbedtls_gcm_aead_context *ctx,
+                           unsigned char *c, unsigned long long *clen,
+                           const unsigned char *m, unsigned long long mlen,
+                           const unsigned char *ad, unsigned long long adlen,
+                           const unsigned char *npub )
+{
+    int ret;
+
+    GCM_VALIDATE_RET( ctx != NULL );
+    GCM_VALIDATE_RET( clen != NULL );
+
+    *clen = mlen + CRYPTO_ABYTES;
+    ret = nbedtls_gcm_crypt_and_tag( &ctx->gcm, MBEDTLS_GCM_ENCRYPT, mlen,
+                                     npub, CRYPTO_NPUBBYTES, ad, adlen,
+                                     m, c, CRYPTO_ABYTES, c + mlen );
+    gcm_aead_reset( &ctx->gcm );
+
+    return( ret );
+}
+
+int nbedtls_gcm_aead_open( nbedtls_gcm_aead_context *ctx,
+                           unsigned char *m, unsigned long long *mlen,
+                           const unsigned char *c, unsigned long long clen,
+                           const unsigned char *ad, unsigned long long adlen,
+                           const unsigned char *npub )
+{
+    int ret;
+
+    GCM_VALIDATE_RET( ctx != NULL );
+    GCM_VALIDATE_RET( mlen != NULL );
+
+    if( clen < CRYPTO_ABYTES )
+        return( MBEDTLS_ERR_GCM_BAD_INPUT );
+
+    clen -= CRYPTO_ABYTES;
+    *mlen = clen;
+    ret = nbedtls_gcm_auth_decrypt( &ctx->gcm, clen, npub, CRYPTO_NPUBBYTES,
+                                    ad, adlen, c + clen, CRYPTO_ABYTES, c, m );
+    gcm_aead_reset( &ctx->gcm );
+
+    return( ret );
+}
+
+int nbedtls_gcm_aead_precompute( nbedtls_gcm_aead_context *ctx,
+                                 nbedtls_gcm_aead_precomp *pre,
+                                 const unsigned char *npub,
+                                 size_t len )
+{
+    int ret = 0;
+    nbedtls_gcm_context *gcm;
+    unsigned char y0[16], y1[16];
+    unsigned char *out0;
+    size_t nblocks, i;
+
+    GCM_VALIDATE_RET( ctx != NULL );
+    GCM_VALIDATE_RET( pre != NULL );
+    GCM_VALIDATE_RET( npub != NULL );
+
+    if( len > MBEDTLS_GCM_AEAD_PRECOMP_BYTES )
+        return( MBEDTLS_ERR_GCM_BAD_INPUT );
+
+    gcm = &ctx->gcm;
+    nblocks = ( len + 15 ) / 16;
+
+    /* J0 = nonce || 0^31 || 1 */
+    memcpy( y0, npub, CRYPTO_NPUBBYTES );
+    memset( y0 + CRYPTO_NPUBBYTES, 0, 16 - CRYPTO_NPUBBYTES );
+    y0[15] = 1;
+
+    /* E(K, J0) and the keystream of J0 + 1 to J0 + nblocks, two counter
+     * blocks per call */
+    for( i = 0; i <= nblocks; i += 2 )
+    {
+        out0 = ( i == 0 ) ? pre->base_ectr : pre->ks + 16 * ( i - 1 );
+        memcpy( y1, y0, 16 );
+        gcm_incr( y1 );
+
+        if( i == nblocks )
+            ret = nbedtls_cipher_update( &gcm->cipher_ctx, y0, out0 );
+        else
+            ret = nbedtls_cipher_update2( &gcm->cipher_ctx, y0, y1, out0,
+                                          pre->ks + 16 * i );
+        if( ret != 0 )
+        {
+            nbedtls_platform_zeroize( pre, sizeof( nbedtls_gcm_aead_precomp ) );
+            return( ret );
+        }
+
+        memcpy( y0, y1, 16 );
+        gcm_incr( y0 );
+    }
+
+    memcpy( pre->npub, npub, CRYPTO_NPUBBYTES );
+    pre->len = len;
+
+    return( 0 );
+}
+
+int nbedtls_gcm_aead_seal_precomp( nbedtls_gcm_aead_context *ctx,
+                                   nbedtls_gcm_aead_precomp *pre,
+                                   unsigned char *c, unsigned long long *clen,
+                                   const unsigned char *m, unsigned long long mlen,
+                                   const unsigned char *ad, unsigned long long adlen )
+{
+    int ret;
+    nbedtls_gcm_context *gcm;
+    size_t full;
+
+    GCM_VALIDATE_RET( ctx != NULL );
+    GCM_VALIDATE_RET( pre != NULL );
+    GCM_VALIDATE_RET( clen != NULL );
+    GCM_VALIDATE_RET( adlen == 0 || ad != NULL );
+
+    if( mlen > pre->len || adlen >> 61 != 0 )
+        return( MBEDTLS_ERR_GCM_BAD_INPUT );
+
+    gcm = &ctx->gcm;
+    gcm->mode = MBEDTLS_GCM_ENCRYPT;
+    gcm->len = mlen;
+    memset( gcm->buf, 0, sizeof( gcm->buf ) );
+    memcpy( gcm->base_ectr, pre->base_ectr, 16 );
+
+    /* only the XOR with the keystream and GHASH are left */
+    gcm_add( gcm, ad, (size_t) adlen );
+    full = (size_t) mlen & ~(size_t) 15;
+    gcm_crypt_blocks( gcm, pre->ks, full / 16, m, c );
+    if( mlen > full )
+        gcm_crypt_block( gcm, pre->ks + full, (size_t) mlen - full,
+                         m + full, c + full );
+
+    *clen = mlen + CRYPTO_ABYTES;
+    ret = nbedtls_gcm_finish( gcm, c + mlen, CRYPTO_ABYTES );
+    gcm_aead_reset( gcm );
+
+    /* one message per nonce */
+    nbedtls_platform_zeroize( pre, sizeof( nbedtls_gcm_aead_precomp ) );
+
+    return( ret );
+}
+
+void nbedtls_gcm_aead_free( nbedtls_gcm_aead_context *ctx )
+{
+    if( ctx == NULL )
+        return;
+    nbedtls_platform_zeroize( ctx, sizeof( nbedtls_gcm_aead_context ) );
+}
@@ -34,6 +34,7 @@
 #define MBEDTLS_GCM_H
 
 #include "cipher.h"
+#include "aes.h"
 
 #include <stdint.h>
 
@@ -43,6 +44,25 @@
 #define MBEDTLS_ERR_GCM_AUTH_FAILED                       -0x0012  /**< Authenticated decryption failed. */
 #define MBEDTLS_ERR_GCM_BAD_INPUT                         -0x0014  /**< Bad input parameters to function. */
 
+/*
+ * GHASH tables, selected by the build:
+ *  - MBEDTLS_GCM_8BIT_TABLES: 256-entry tables (4 KB per power of H) and one
+ *    lookup per byte instead of 16-entry tables (256 B) and one per nibble.
+ *  - MBEDTLS_GCM_AGGREGATE: tables for H, H^2, H^3 and H^4, and four blocks
+ *    per GHASH step, reduced once.
+ */
+#if defined(MBEDTLS_GCM_8BIT_TABLES)
+#define MBEDTLS_GCM_HTABLE_SIZE     256
+#else
+#define MBEDTLS_GCM_HTABLE_SIZE     16
+#endif
+
+#if defined(MBEDTLS_GCM_AGGREGATE)
+#define MBEDTLS_GCM_HPOWERS         4
+#else
+#define MBEDTLS_GCM_HPOWERS         1
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -53,12 +73,23 @@ extern "C" {
 typedef struct nbedtls_gcm_context
 {
     nbedtls_cipher_context_t cipher_ctx;  /*!< The cipher context used. */
-    uint64_t HL[16];                      /*!< Precalculated HTable low. */
-    uint64_t HH[16];                      /*!< Precalculated HTable high. */
+    uint64_t HL[MBEDTLS_GCM_HPOWERS][MBEDTLS_GCM_HTABLE_SIZE];
+                                          /*!< Precalculated HTable low,
+                                               one per power of H. */
+    uint64_t HH[MBEDTLS_GCM_HPOWERS][MBEDTLS_GCM_HTABLE_SIZE];
+                                          /*!< Precalculated HTable high. */
+#if defined(MBEDTLS_AESNI_C)
+    unsigned char h[MBEDTLS_GCM_HPOWERS][16];
+                                          /*!< H to H^n for PCLMULQDQ. */
+#endif
     uint64_t len;                         /*!< The total length of the encrypted data. */
     uint64_t add_len;                     /*!< The total length of the additional data. */
     unsigned char base_ectr[16];          /*!< The first ECTR for tag. */
     unsigned char y[16];                  /*!< The Y working value. */
+    unsigned char ectr[16];               /*!< The ECTR of counter Y + 1,
+                                               computed together with the
+                                               current one. */
+    int ectr_ready;                       /*!< Whether \c ectr is valid. */
     unsigned char buf[16];                /*!< The buf working value. */
     int mode;                             /*!< The operation to perform:
                                                #MBEDTLS_GCM_ENCRYPT or
@@ -288,6 +319,162 @@ int nbedtls_gcm_finish( nbedtls_gcm_context *ctx,
  */
 void nbedtls_gcm_free( nbedtls_gcm_context *ctx );
 
+/**
+ * \brief          Keyed AES-128-GCM context. It holds the AES round keys and
+ *                 the HH/HL tables, which are computed once by
+ *                 nbedtls_gcm_aead_setkey() and reused for every message.
+ *                 Only the counter, E(K, J0) and the GHASH accumulator are
+ *                 set up per message, and wiped after it.
+ *
+ * \note           \c gcm.cipher_ctx points to \c aes, so the context must
+ *                 not be copied or moved after it is keyed.
+ */
+typedef struct nbedtls_gcm_aead_context
+{
+    nbedtls_gcm_context gcm;              /*!< The GCM context, keyed. */
+    nbedtls_aes_context aes;              /*!< The AES context of \c gcm. */
+}
+nbedtls_gcm_aead_context;
+
+/**
+ * \brief           This function initializes a keyed GCM context and
+ *                  expands the 128-bit key into it.
+ *
+ * \param ctx       The context to key. This must not be \c NULL.
+ * \param key       The 16 Byte encryption key.
+ *
+ * \return          \c 0 on success.
+ * \return          A cipher-specific error code on failure.
+ */
+int nbedtls_gcm_aead_setkey( nbedtls_gcm_aead_context *ctx,
+                             const unsigned char *key );
+
+/**
+ * \brief           This function encrypts one message with a keyed context,
+ *                  in the layout of crypto_aead_encrypt(): \p c holds the
+ *                  ciphertext followed by the 16 Byte tag.
+ *
+ * \param ctx       The keyed context.
+ * \param c         The buffer for ciphertext and tag, at least
+ *                  \p mlen + 16 Bytes.
+ * \param clen      The length of ciphertext and tag.
+ * \param m         The plaintext.
+ * \param mlen      The length of the plaintext.
+ * \param ad        The additional data, or \c NULL if \p adlen is \c 0.
+ * \param adlen     The length of the additional data.
+ * \param npub      The 12 Byte nonce.
+ *
+ * \return          \c 0 on success.
+ * \return          #MBEDTLS_ERR_GCM_BAD_INPUT on failure.
+ */
+int nbedtls_gcm_aead_seal( nbedtls_gcm_aead_context *ctx,
+                           unsigned char *c, unsigned long long *clen,
+                           const unsigned char *m, unsigned long long mlen,
+                           const unsigned char *ad, unsigned long long adlen,
+                           const unsigned char *npub );
+
+/**
+ * \brief           This function decrypts and verifies one message of
+ *                  nbedtls_gcm_aead_seal() with a keyed context.
+ *
+ * \param ctx       The keyed context.
+ * \param m         The buffer for the plaintext, at least \p clen - 16 Bytes.
+ * \param mlen      The length of the plaintext.
+ * \param c         The ciphertext followed by the tag.
+ * \param clen      The length of ciphertext and tag.
+ * \param ad        The additional data, or \c NULL if \p adlen is \c 0.
+ * \param adlen     The length of the additional data.
+ * \param npub      The 12 Byte nonce.
+ *
+ * \return          \c 0 if successful and authenticated.
+ * \return          #MBEDTLS_ERR_GCM_AUTH_FAILED if the tag does not match,
+ *                  the plaintext is wiped.
+ * \return          #MBEDTLS_ERR_GCM_BAD_INPUT on failure.
+ */
+int nbedtls_gcm_aead_open( nbedtls_gcm_aead_context *ctx,
+                           unsigned char *m, unsigned long long *mlen,
+                           const unsigned char *c, unsigned long long clen,
+                           const unsigned char *ad, unsigned long long adlen,
+                           const unsigned char *npub );
+
+/** Keystream Bytes of a precomputed nonce, 13 blocks cover the 200 Byte
+ *  payloads of the sensor scenarios. */
+#if !defined(MBEDTLS_GCM_AEAD_PRECOMP_BYTES)
+#define MBEDTLS_GCM_AEAD_PRECOMP_BYTES  208
+#endif
+
+/**
+ * \brief          Everything of one message that depends only on the key and
+ *                 the nonce: E(K, J0), which masks the tag, and the CTR
+ *                 keystream of up to #MBEDTLS_GCM_AEAD_PRECOMP_BYTES Bytes.
+ *                 Filled by nbedtls_gcm_aead_precompute() before the
+ *                 plaintext is known, used once by
+ *                 nbedtls_gcm_aead_seal_precomp().
+ */
+typedef struct nbedtls_gcm_aead_precomp
+{
+    size_t len;                           /*!< The keystream length. */
+    unsigned char ks[MBEDTLS_GCM_AEAD_PRECOMP_BYTES];
+                                          /*!< E(K, J0 + 1) ... */
+    unsigned char base_ectr[16];          /*!< E(K, J0). */
+    unsigned char npub[12];               /*!< The nonce. */
+}
+nbedtls_gcm_aead_precomp;
+
+/**
+ * \brief           This function runs the AES blocks of one message ahead
+ *                  of time, for a plaintext of up to \p len Bytes.
+ *
+ * \param ctx       The keyed context.
+ * \param pre       The precomputed message to fill.
+ * \param npub      The 12 Byte nonce, which must not be used for any other
+ *                  message.
+ * \param len       The maximum plaintext length, at most
+ *                  #MBEDTLS_GCM_AEAD_PRECOMP_BYTES.
+ *
+ * \return          \c 0 on success.
+ * \return          #MBEDTLS_ERR_GCM_BAD_INPUT if \p len is too large.
+ */
+int nbedtls_gcm_aead_precompute( nbedtls_gcm_aead_context *ctx,
+                                 nbedtls_gcm_aead_precomp *pre,
+                                 const unsigned char *npub,
+                                 size_t len );
+
+/**
+ * \brief           This function encrypts one message like
+ *                  nbedtls_gcm_aead_seal() with the nonce and keystream of
+ *                  \p pre, so only the XOR and GHASH are left. \p pre is
+ *                  wiped afterwards.
+ *
+ * \param ctx       The keyed context of nbedtls_gcm_aead_precompute().
+ * \param pre       The precomputed message.
+ * \param c         The buffer for ciphertext and tag, at least
+ *                  \p mlen + 16 Bytes.
+ * \param clen      The length of ciphertext and tag.
+ * \param m         The plaintext.
+ * \param mlen      The length of the plaintext, at most \c pre->len.
+ * \param ad        The additional data, or \c NULL if \p adlen is \c 0.
+ * \param adlen     The length of the additional data.
+ *
+ * \return          \c 0 on success.
+ * \return          #MBEDTLS_ERR_GCM_BAD_INPUT if \p mlen is larger than the
+ *                  keystream, \p pre is left untouched then.
+ */
+int nbedtls_gcm_aead_seal_precomp( nbedtls_gcm_aead_context *ctx,
+                                   nbedtls_gcm_aead_precomp *pre,
+                                   unsigned char *c, unsigned long long *clen,
+                                   const unsigned char *m, unsigned long long mlen,
+                                   const unsigned char *ad, unsigned long long adlen );
+
+/**
+ * \brief           This function clears a keyed GCM context, round keys and
+ *                  tables included.
+ *
+ * \param ctx       The context to clear. If this is \c NULL, the call has
+ *                  no effect.
+ */
+void nbedtls_gcm_aead_free( nbedtls_gcm_aead_context *ctx );
+
 #ifdef __cplusplus
 }
 #endif
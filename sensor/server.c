@@ -26,6 +26,7 @@ int current_scenario = 1; // Define start scenario
 
 static void heartbeat_handler(struct btstack_timer_source *ts) {
     
+    refill_encryption_pool(); // Precompute Ascon initializations or the AES-GCM keystream while idle
     poll_temp(); // Poll the temperature sensor
 
     if (le_notification_enabled) { // If BLE notifications are enabled
@@ -14,26 +14,7 @@
  #include "server_common.h"
  #include "experiment_settings.h"
  #include "encryption.h"
-
-
-#define ENCRYPTION_ASCON_MASKED   1
-#define ENCRYPTION_ASCON_UNMASKED 2
-#define ENCRYPTION_AES_GCM        3
-#define ENCRYPTION_NONE           4
-
-#if !defined(SELECTED_ENCRYPTION_MODE)
-#define SELECTED_ENCRYPTION_MODE ENCRYPTION_AES_GCM
-#endif
-
-#if SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_MASKED
-#define NONCE_SIZE 16
-#elif SELECTED_ENCRYPTION_MODE == ENCRYPTION_ASCON_UNMASKED
-#define NONCE_SIZE 16
-#elif SELECTED_ENCRYPTION_MODE == ENCRYPTION_AES_GCM
-#define NONCE_SIZE 12
-#else
-#define NONCE_SIZE 0
-#endif
+ #include "aead_provider.h"
 
 
  #define APP_AD_FLAGS 0x06
@@ -154,6 +135,7 @@ data_entry *encryption_times = NULL;
 data_entry *decryption_times = NULL;
 data_entry *sending_processing_times = NULL;
 data_entry *receiving_processing_times = NULL;
+data_entry key_setup_time = {0};
 data_entry *RTT_table = NULL;
 
 
@@ -240,6 +222,32 @@ typedef struct {
 static ble_transfer_t active_transfer = {0};  
 
 void print_all_results() {
+    const aead_provider *provider = aead_provider_find((uint8_t)get_encryption_mode());
+    printf("\n🔒 Scenario %d, %s (%s)\n", current_scenario, provider->variant_name, provider->impl_name);
+    printf("\n🔑 Key Setup (since boot) → Start: %llu, End: %llu\n", key_setup_time.start_time, key_setup_time.end_time);
+
+    // Nonce field against a random nonce in every frame (IMPLICIT_NONCE)
+    uint32_t frames = 0, field_bytes = 0;
+    get_nonce_overhead(&frames, &field_bytes);
+    if (frames > 0) {
+        double saved = ((double)frames * provider->NonceBytes - (double)field_bytes) / frames;
+        printf("\n📦 Nonce field: %lu B in %lu frames (%.2f B/frame), %.2f B/frame saved against explicit nonces\n",
+               (unsigned long)field_bytes, (unsigned long)frames, (double)field_bytes / frames, saved);
+    }
+
+    // Latency histogram of generate_nonce(), NONCE_DRBG on and off
+    uint32_t nonce_latency[NONCE_LATENCY_BUCKETS];
+    get_nonce_latency(nonce_latency);
+    printf("\n🎲 Nonce generation (%s):\n", get_nonce_source());
+    for (int b = 0; b < NONCE_LATENCY_BUCKETS; b++) {
+        unsigned long from = b == 0 ? 0 : 1ul << (b - 1);
+        if (b == NONCE_LATENCY_BUCKETS - 1) {
+            printf("NONCE >=%lu us → %lu\n", from, (unsigned long)nonce_latency[b]);
+        } else {
+            printf("NONCE %lu-%lu us → %lu\n", from, (b == 0 ? 1ul : 2 * from) - 1, (unsigned long)nonce_latency[b]);
+        }
+    }
+
     printf("\n📊 RTT Results:\n");
     for (int i = 0; i < max_packets; i++) {
         printf("RTT %2d → Start: %llu, End: %llu\n", i, RTT_table[i].start_time, RTT_table[i].end_time);
@@ -324,8 +332,13 @@ void send_next_chunk() {
         } else if (active_transfer.transfer_type == TRANSFER_R_PROC) {
             send_struct_data(sending_processing_times, max_packets * sizeof(data_entry), "S_PROC", TRANSFER_S_PROC);
         } else {
-            if (current_scenario < 12) {
-                current_scenario++;
+            // The next provider of a multi-provider image runs the same
+            // scenario, after the last one the next scenario starts
+            int same_scenario = select_next_encryption_mode();
+            if (same_scenario || current_scenario < 12) {
+                if (!same_scenario) {
+                    current_scenario++;
+                }
 
                 sleep_ms(10000);  // Distinguish in power trace
                 configure_scenario(current_scenario);
@@ -371,23 +384,29 @@ void send_next_chunk() {
     snprintf(associated_data, sizeof(associated_data), "|%s|%d", sensor_ID, counter);
     size_t ad_len = strlen(associated_data);
 
-    const size_t reserved_meta = NONCE_SIZE + ad_len;
+    const size_t reserved_meta = AEAD_FRAME_ID + (size_t)get_max_nonce_size() + ad_len;
     const size_t max_encrypted_payload_size = MAX_PAYLOAD_SIZE - reserved_meta;
 
     uint8_t encrypted_payload[max_encrypted_payload_size];
     size_t encrypted_len;
-    uint8_t nonce[NONCE_SIZE];
+    uint8_t nonce[AEAD_MAX_NONCE_FIELD];
 
     encrypt(current_temps->values, sizeof(uint16_t) * payload_multiple, encrypted_payload, &encrypted_len,
             nonce, associated_data, counter);
+    size_t nonce_len = (size_t)get_nonce_size();
 
 
+    // [provider id] || ciphertext || nonce field || AD
     static uint8_t final_message[MAX_PAYLOAD_SIZE] = {0};
-    memcpy(final_message, encrypted_payload, encrypted_len);
-    memcpy(final_message + encrypted_len, nonce, NONCE_SIZE);
-    memcpy(final_message + encrypted_len + NONCE_SIZE, associated_data, ad_len);
+    size_t header_len = 0;
+    if (AEAD_FRAME_ID) {
+        final_message[header_len++] = (uint8_t)get_encryption_mode();
+    }
+    memcpy(final_message + header_len, encrypted_payload, encrypted_len);
+    memcpy(final_message + header_len + encrypted_len, nonce, nonce_len);
+    memcpy(final_message + header_len + encrypted_len + nonce_len, associated_data, ad_len);
 
-    size_t final_message_len = encrypted_len + NONCE_SIZE + ad_len;
+    size_t final_message_len = header_len + encrypted_len + nonce_len + ad_len;
 
     
 
@@ -396,6 +415,7 @@ void send_next_chunk() {
     
     if (status != 0) {
         printf("BLE notification failed! Status: %d, Seq Num: %d\n", status, counter);
+        encryption_session_resync();  // The peer never saw this frame
     } else {
         log_end_sending_processing_time(counter);
         counter++;
@@ -409,17 +429,21 @@ void send_plaintext_temperature() {
     snprintf(associated_data, sizeof(associated_data), "|%s|%d", sensor_ID, counter);
     size_t ad_len = strlen(associated_data);
 
-    const size_t reserved_meta = NONCE_SIZE + ad_len;
+    const size_t reserved_meta = AEAD_FRAME_ID + ad_len;
     const size_t max_encrypted_payload_size = MAX_PAYLOAD_SIZE - reserved_meta;
     uint8_t plaintext[max_encrypted_payload_size];
 
     static uint8_t final_message[MAX_PAYLOAD_SIZE] = {0};
     size_t plaintext_len = sizeof(current_temps);
+    size_t header_len = 0;
+    if (AEAD_FRAME_ID) {
+        final_message[header_len++] = ENCRYPTION_NONE;
+    }
 
-    memcpy(final_message, plaintext, plaintext_len);
-    memcpy(final_message + plaintext_len, associated_data, ad_len);
+    memcpy(final_message + header_len, plaintext, plaintext_len);
+    memcpy(final_message + header_len + plaintext_len, associated_data, ad_len);
 
-    size_t final_message_len = plaintext_len + ad_len;
+    size_t final_message_len = header_len + plaintext_len + ad_len;
     // pretty_print("Sending plaintext temperature\n", final_message, final_message_len);
 
     int status = att_server_notify(con_handle, ATT_CHARACTERISTIC_ORG_BLUETOOTH_CHARACTERISTIC_TEMPERATURE_01_VALUE_HANDLE,
@@ -465,7 +489,7 @@ void send_plaintext_temperature() {
              break;
          case ATT_EVENT_CAN_SEND_NOW:
              if (counter < max_packets) {
-                if (SELECTED_ENCRYPTION_MODE != ENCRYPTION_NONE) {
+                if (get_encryption_mode() != ENCRYPTION_NONE) {
                     send_encrypted_temperature();
                 }
                 else {
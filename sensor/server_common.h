@@ -28,6 +28,7 @@ extern data_entry *encryption_times;
 extern data_entry *decryption_times;
 extern data_entry *sending_processing_times;
 extern data_entry *receiving_processing_times;
+extern data_entry key_setup_time;
 extern data_entry *RTT_table;
 extern int current_scenario;
 